@@ -0,0 +1,162 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbalns.h
+  `````````````
+  Adaptive large neighborhood search (Ropke and
+  Pisinger, 2006) around a MIP model: an operator
+  chooses the part of the incumbent that is freed, the
+  other integer variables are fixed to their incumbent
+  values by their bounds, and the small MIP that
+  remains is re-solved on the same problem object with
+  the incumbent as start solution (the repair).
+
+  The operator is drawn with probability proportional
+  to its weight. Its score in a segment of ALNSSEGMENT
+  iterations depends on the outcome of the repair: a
+  new incumbent, the incumbent again, or no solution in
+  the time box. At the end of a segment the weights move
+  towards the mean score by the reaction factor.
+
+  The share of the variables that is freed follows the
+  repairs: it grows after a repair that was solved to
+  optimality and shrinks after one that hit the time
+  box.
+********************************************************/
+
+#ifndef XBALNS_H
+#define XBALNS_H
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include "xbcls.h"
+
+#define ALNSSEGMENT 10                  /* Iterations per weight update */
+#define ALNSREACTION 0.3                /* Reaction factor of the weights */
+#define ALNSMINWEIGHT 0.05              /* Lower bound of a weight */
+
+#define ALNS_BEST 0                     /* Outcomes of a repair */
+#define ALNS_SAME 1
+#define ALNS_FAIL 2
+
+static const double ALNSSCORE[3] = {10, 2, 0};   /* Score per outcome */
+
+typedef struct {
+    const char *name;
+    double weight;                      /* Selection weight */
+    double score;                       /* Score in the current segment */
+    int uses;                           /* Uses in the current segment */
+    int calls, wins;                    /* Total uses and new incumbents */
+} ALNSOp;
+
+typedef struct {
+    std::vector<ALNSOp> op;
+    double free;                        /* Share of the variables freed */
+    double minfree, maxfree;
+    int iter;
+    std::mt19937 rng;
+} ALNSState;
+
+/* Repair with operator op in at most timebox sec; the callback keeps the
+   solution if it is better than best and sets *optimal if the
+   neighborhood was solved to optimality.
+   Return value: cost of the repaired solution, HUGE_VAL if none */
+typedef std::function<double(int op, double timebox, double best, int *optimal)> ALNSRepair;
+
+static inline void alnsInit(ALNSState *st, const char **names, int nop, double free, unsigned seed) {
+    int k;
+
+    st->op.resize(nop);
+    for (k = 0; k < nop; k++) {
+        st->op[k].name = names[k];
+        st->op[k].weight = 1;
+        st->op[k].score = 0;
+        st->op[k].uses = 0;
+        st->op[k].calls = st->op[k].wins = 0;
+    }
+    st->free = free;
+    st->minfree = free / 4;
+    st->maxfree = std::min(1.0, 4 * free);
+    st->iter = 0;
+    st->rng.seed(seed);
+}
+
+/* Roulette wheel selection on the weights */
+static inline int alnsSelect(ALNSState *st) {
+    int k;
+    double sum = 0, r;
+
+    for (k = 0; k < (int) st->op.size(); k++) sum += st->op[k].weight;
+    r = std::uniform_real_distribution<double>(0.0, sum)(st->rng);
+    for (k = 0; k < (int) st->op.size() - 1; k++) {
+        r -= st->op[k].weight;
+        if (r < 0) break;
+    }
+    return k;
+}
+
+/* Score the outcome of operator k; new weights at the end of a segment */
+static inline void alnsReward(ALNSState *st, int k, int outcome) {
+    int j;
+    ALNSOp *o;
+
+    st->op[k].score += ALNSSCORE[outcome];
+    st->op[k].uses++;
+    st->op[k].calls++;
+    if (outcome == ALNS_BEST) st->op[k].wins++;
+    if (++st->iter % ALNSSEGMENT) return;
+    for (j = 0; j < (int) st->op.size(); j++) {
+        o = &st->op[j];
+        if (o->uses > 0)
+            o->weight = std::max(ALNSMINWEIGHT, (1 - ALNSREACTION) * o->weight + ALNSREACTION * o->score / o->uses);
+        o->score = 0;
+        o->uses = 0;
+    }
+}
+
+/**************************************************************************/
+/* Repeat select - repair - reward until maxtime sec have passed; each    */
+/* repair gets at most timebox sec.                                       */
+/* Return value: cost of the incumbent                                    */
+/**************************************************************************/
+static inline double alnsRun(ALNSState *st, double cost, double maxtime, double timebox,
+                             const ALNSRepair &repair, CLSStats *stats) {
+    int k, optimal, outcome;
+    double t0, start = clsClock(), left, z;
+
+    while ((left = maxtime - (clsClock() - start)) > 0) {
+        k = alnsSelect(st);
+        t0 = clsClock();
+        optimal = 0;
+        z = repair(k, std::min(timebox, left), cost, &optimal);
+        if (z < cost - 1e-6 * std::max(1.0, fabs(cost))) {
+            outcome = ALNS_BEST;
+            cost = z;
+            std::cout << "ALNS " << st->iter + 1 << ": " << st->op[k].name << ", cost " << cost << std::endl;
+        } else
+            outcome = (z < HUGE_VAL ? ALNS_SAME : ALNS_FAIL);
+        alnsReward(st, k, outcome);
+        if (optimal)                    /* Adapt the neighborhood size */
+            st->free = std::min(st->maxfree, st->free * 1.1);
+        else
+            st->free = std::max(st->minfree, st->free * 0.9);
+        clsRecord(stats, st->op[k].name, clsClock() - t0, outcome == ALNS_BEST);
+    }
+    return cost;
+}
+
+static inline void alnsPrintStats(const ALNSState *st) {
+    int k;
+
+    std::cout << "ALNS operators (weight, uses, new incumbents):" << std::endl;
+    for (k = 0; k < (int) st->op.size(); k++)
+        std::cout << "   " << st->op[k].name << ": " << st->op[k].weight << ", " << st->op[k].calls << ", "
+                  << st->op[k].wins << std::endl;
+}
+
+#endif
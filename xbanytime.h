@@ -0,0 +1,53 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbanytime.h
+  ````````````````
+  Helpers of the anytime solves (solve against a
+  wall-clock limit, reporting each improved solution or
+  bound through a callback):
+
+    xbPrintProgress   progress report callback; its
+                      data is the XPRB::getTime() at the
+                      start
+    xbLimitLP         stops the LPs of a problem at a
+                      deadline in milliseconds; the
+                      optimizer's MAXTIME counts whole
+                      seconds only
+********************************************************/
+
+#ifndef XBANYTIME_H
+#define XBANYTIME_H
+
+#include <iostream>
+#include "xprb_cpp.h"
+#include "xprs.h"
+
+#define XBLIMITLOG 10           /* LP iterations between deadline checks */
+
+static inline void xbPrintProgress(double obj, double bound, void *data) {
+    std::cout << "(" << (::dashoptimization::XPRB::getTime() - *(int *) data) / 1000.0 << " sec) best "
+              << obj << ", bound " << bound << std::endl;
+}
+
+/* lplog callback; data: the deadline (XPRB::getTime()) */
+static inline int XPRS_CC xbCbDeadline(XPRSprob xprob, void *data) {
+    if (::dashoptimization::XPRB::getTime() < *(int *) data) return 0;
+    XPRSinterrupt(xprob, XPRS_STOP_TIMELIMIT);
+    return 1;                                   /* Nonzero stops the LP */
+}
+
+/**************************************************************************/
+/* Interrupt the LPs of xprob at *deadline (on = 1) or stop doing so      */
+/* (on = 0, before the deadline variable goes out of scope)               */
+/**************************************************************************/
+static inline void xbLimitLP(XPRSprob xprob, int *deadline, int on) {
+    if (on) {
+        XPRSsetintcontrol(xprob, XPRS_LPLOG, XBLIMITLOG);
+        XPRSaddcblplog(xprob, xbCbDeadline, deadline, 0);
+    } else
+        XPRSremovecblplog(xprob, xbCbDeadline, deadline);
+}
+
+#endif
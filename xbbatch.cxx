@@ -0,0 +1,491 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbbatch.cxx
+  ````````````````
+  Batch runs of the solvers, scheduled by predicted
+  solution time to keep the makespan short.
+
+  A job file has one job per line: a solver command with
+  its arguments (e.g. './xbcutstk data/cs3.dat'); the
+  family of a job is the name of the solver. For every
+  job the time on one thread is predicted from:
+
+    the earlier runs of the same job in the history
+    file (telemetry appended after every run), else
+    a least-squares model of log(time) over the
+    instance features, fitted to the history of the
+    family (the solvers in FEATUREFAMILIES print their
+    features with -features), else
+    the geometric mean time of the family, else
+    DEFAULTSEC
+
+  Times on k threads follow t(k) = t(1)*(SERIAL +
+  (1-SERIAL)/k). With C cores the ideal makespan is
+  L = sum t(1) / C; a job longer than L gets threads
+  until it is no longer (at most MAXJOBTHREADS), the
+  others run on one thread. Jobs start longest first
+  (LPT order) as soon as their threads are free, and
+  run with -threads k. A job runs as a task of the
+  thread pool (xbthreads.h), so no more jobs run at a
+  time than the machine has cores; while the next job
+  waits for cores the main thread runs queued jobs.
+
+  With -numa the cores are those of the NUMA nodes
+  (xbnuma.h) and a job runs pinned to the node with the
+  most free cores that has enough for it, so that the
+  solver's memory is allocated on that node; a job
+  needing more cores than a node has runs unpinned. The
+  jobs and the utilization of every node are reported.
+
+  A job answered from a solver's solution cache (exit
+  status XBCACHEHIT, see xbcache.h) is reported as a
+  cache hit and not added to the history.
+
+  The makespan is compared with the jobs in file order
+  on one thread each, simulated with the measured times.
+  With -dry the schedule and the predicted makespans are
+  printed without running the jobs.
+
+  Usage: xbbatch jobfile [-cores n | -numa] [-hist file]
+                 [-dry] [-logs]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <sys/wait.h>
+#include "xbcls.h"
+#include "xbcache.h"
+#include "xbthreads.h"
+#include "xbnuma.h"
+
+using namespace std;
+
+#define SERIAL 0.4             /* Serial share of a solver run */
+#define MAXJOBTHREADS 8        /* Max. threads of a job */
+#define DEFAULTSEC 1.0         /* Prediction without any history */
+#define MAXFEATURES 16
+
+const char *FEATUREFAMILIES[] = {"xbcutstk", "xbcls"};
+
+typedef struct {
+    string cmd;                         /* Command line */
+    string family;                      /* Solver name */
+    vector<double> feat;                /* Instance features, may be empty */
+    double pred;                        /* Predicted time on one thread */
+    const char *source;                 /* What the prediction is based on */
+    int threads;
+    int node;                           /* NUMA node, -1 if not pinned */
+    double sec;                         /* Measured time, -1 if failed */
+    int cached;                         /* Answered from the solver's cache */
+} Job;
+
+typedef struct {                        /* A run in the history file */
+    string family, cmd;
+    int threads;
+    double sec;
+    vector<double> feat;
+} Run;
+
+/****DATA****/
+vector<Job> JOBS;
+vector<Run> HIST;
+CLSStats stats;
+
+/***********************************************************************/
+
+/* Time on k threads relative to one thread */
+double speed(int k) {
+    return SERIAL + (1 - SERIAL) / k;
+}
+
+string familyOf(const string &cmd) {
+    string s = cmd.substr(0, cmd.find(' '));
+
+    return s.substr(s.find_last_of('/') + 1);
+}
+
+int readJobs(const char *fname) {
+    string line;
+    Job j;
+    ifstream in(fname);
+
+    while (getline(in, line)) {
+        if (line.find_first_not_of(" \t") == string::npos || line[0] == '#') continue;
+        j.cmd = line;
+        j.family = familyOf(line);
+        j.pred = DEFAULTSEC;
+        j.source = "none";
+        j.threads = 1;
+        j.node = -1;
+        j.sec = -1;
+        j.cached = 0;
+        JOBS.push_back(j);
+    }
+    return (int) JOBS.size();
+}
+
+/* History lines: 'family threads sec nfeat f1 .. fn command' */
+void readHistory(const char *fname) {
+    int k, n;
+    string line;
+    Run r;
+    ifstream in(fname);
+
+    while (getline(in, line)) {
+        istringstream ls(line);
+        if (!(ls >> r.family >> r.threads >> r.sec >> n) || n < 0 || n > MAXFEATURES) continue;
+        r.feat.resize(n);
+        for (k = 0; k < n; k++) ls >> r.feat[k];
+        ls >> ws;
+        if (!getline(ls, r.cmd) || r.threads < 1) continue;
+        HIST.push_back(r);
+    }
+}
+
+void appendHistory(const char *fname, const Job &j) {
+    size_t k;
+    ofstream out(fname, ios::app);
+
+    out << j.family << " " << j.threads << " " << j.sec << " " << j.feat.size();
+    for (k = 0; k < j.feat.size(); k++) out << " " << j.feat[k];
+    out << " " << j.cmd << endl;
+}
+
+/* Features printed by 'cmd -features' for the families supporting it */
+void getFeatures(Job &j) {
+    size_t k;
+    double v;
+    char buf[1024];
+    FILE *f;
+
+    for (k = 0; k < sizeof(FEATUREFAMILIES) / sizeof(FEATUREFAMILIES[0]); k++)
+        if (j.family == FEATUREFAMILIES[k]) break;
+    if (k == sizeof(FEATUREFAMILIES) / sizeof(FEATUREFAMILIES[0])) return;
+    if ((f = popen((j.cmd + " -features 2>/dev/null").c_str(), "r")) == NULL) return;
+    while (fgets(buf, sizeof(buf), f) != NULL)
+        if (!strncmp(buf, "Features:", 9)) {
+            istringstream ls(buf + 9);
+            while (ls >> v && j.feat.size() < MAXFEATURES) j.feat.push_back(v);
+        }
+    pclose(f);
+}
+
+/**************************************************************************/
+/*  Least squares fit of log(time on one thread) = w0 + sum w[k]*f[k]     */
+/*  over the runs of a family with n features, by Gaussian elimination    */
+/*  on the (slightly regularized) normal equations.                       */
+/*  Return value: 0 if there are fewer runs than n+2                      */
+/**************************************************************************/
+int fitLogTime(const string &family, int n, vector<double> &w) {
+    int i, k, l, r, m = n + 1, nrows = 0;
+    double piv, y;
+    vector<double> v(m);
+    vector<vector<double> > A(m, vector<double>(m + 1, 0));
+
+    for (i = 0; i < (int) HIST.size(); i++) {
+        if (HIST[i].family != family || (int) HIST[i].feat.size() != n) continue;
+        v[0] = 1;
+        for (k = 0; k < n; k++) v[k + 1] = HIST[i].feat[k];
+        y = log(HIST[i].sec / speed(HIST[i].threads) + 1e-3);
+        for (k = 0; k < m; k++) {
+            for (l = 0; l < m; l++) A[k][l] += v[k] * v[l];
+            A[k][m] += v[k] * y;
+        }
+        nrows++;
+    }
+    if (nrows < n + 2) return 0;
+
+    for (k = 0; k < m; k++) A[k][k] += 1e-6 * nrows;
+    for (k = 0; k < m; k++) {
+        for (r = k, i = k + 1; i < m; i++)
+            if (fabs(A[i][k]) > fabs(A[r][k])) r = i;
+        swap(A[k], A[r]);
+        for (i = 0; i < m; i++)
+            if (i != k) {
+                piv = A[i][k] / A[k][k];
+                for (l = k; l <= m; l++) A[i][l] -= piv * A[k][l];
+            }
+    }
+    w.resize(m);
+    for (k = 0; k < m; k++) w[k] = A[k][m] / A[k][k];
+    return 1;
+}
+
+void predict(Job &j) {
+    int i, k, n = 0;
+    double sum = 0;
+    vector<double> w;
+
+    for (i = 0; i < (int) HIST.size(); i++)      /* Same job before */
+        if (HIST[i].cmd == j.cmd) {
+            sum += HIST[i].sec / speed(HIST[i].threads);
+            n++;
+        }
+    if (n > 0) {
+        j.pred = sum / n;
+        j.source = "history";
+        return;
+    }
+    if (!j.feat.empty() && fitLogTime(j.family, (int) j.feat.size(), w)) {
+        for (sum = w[0], k = 0; k < (int) j.feat.size(); k++) sum += w[k + 1] * j.feat[k];
+        j.pred = exp(sum);
+        j.source = "features";
+        return;
+    }
+    for (i = 0; i < (int) HIST.size(); i++)
+        if (HIST[i].family == j.family) {
+            sum += log(HIST[i].sec / speed(HIST[i].threads) + 1e-3);
+            n++;
+        }
+    if (n > 0) {
+        j.pred = exp(sum / n);
+        j.source = "family";
+    }
+}
+
+/*  Threads by predicted hardness: a job longer than the ideal makespan  */
+/*  gets threads until it is no longer                                   */
+void allocThreads(int ncores) {
+    int i, k;
+    double L = 0;
+
+    for (i = 0; i < (int) JOBS.size(); i++) L += JOBS[i].pred;
+    L /= ncores;
+    for (i = 0; i < (int) JOBS.size(); i++) {
+        for (k = 1; k < min(ncores, MAXJOBTHREADS) && JOBS[i].pred * speed(k) > L; k++);
+        JOBS[i].threads = k;
+    }
+}
+
+/**************************************************************************/
+/*  Makespan of starting the jobs in the given order, each as soon as     */
+/*  its threads are free (no job overtakes another).                      */
+/**************************************************************************/
+double makespan(const vector<int> &order, const vector<int> &threads, const vector<double> &dur, int ncores) {
+    int i, j, k, freec = ncores;
+    double now = 0, end = 0;
+    vector<double> fin;                 /* Running jobs */
+    vector<int> use;
+
+    for (i = 0; i < (int) order.size(); i++) {
+        j = order[i];
+        while (freec < min(threads[j], ncores)) {  /* Wait for the next to end */
+            k = (int) (min_element(fin.begin(), fin.end()) - fin.begin());
+            now = max(now, fin[k]);
+            freec += use[k];
+            fin.erase(fin.begin() + k);
+            use.erase(use.begin() + k);
+        }
+        freec -= min(threads[j], ncores);
+        fin.push_back(now + dur[j]);
+        use.push_back(min(threads[j], ncores));
+        end = max(end, now + dur[j]);
+    }
+    return end;
+}
+
+/**************************************************************************/
+/*  Run the jobs in the given order on ncores cores; with nm on its       */
+/*  nodes, a job pinned to the node with the most free cores that has     */
+/*  enough for it, or unpinned on cores of several nodes if it needs      */
+/*  more than a node has.                                                 */
+/*  Return value: makespan (sec)                                          */
+/**************************************************************************/
+double runJobs(const vector<int> &order, int ncores, int logs, const XBNuma *nm) {
+    int i, n, nnodes = (nm != NULL ? xbNumaNodes(nm) : 1), maxnode = 0, freec = ncores, ran;
+    double t0 = clsClock();
+    mutex lock;
+    condition_variable done;
+    XBTaskGroup g;
+    vector<int> nodefree(nnodes, ncores);
+    vector<vector<int> > take(JOBS.size(), vector<int>(nnodes, 0));
+
+    for (n = 0; nm != NULL && n < nnodes; n++) {
+        nodefree[n] = (int) nm->cpus[n].size();
+        maxnode = max(maxnode, nodefree[n]);
+    }
+    /* Node for k threads, -1: unpinned, -2: wait */
+    auto pick = [&](int k) {
+        int n, best = -1;
+
+        if (nm == NULL) return freec >= k ? -1 : -2;
+        for (n = 0; n < nnodes; n++)
+            if (nodefree[n] >= k && (best < 0 || nodefree[n] > nodefree[best])) best = n;
+        if (best >= 0) return best;
+        return k > maxnode && freec >= k ? -1 : -2;
+    };
+
+    xbGroupInit(&g, NULL);
+    for (i = 0; i < (int) order.size(); i++) {
+        Job *j = &JOBS[order[i]];
+        int k = min(j->threads, ncores), id = order[i], left;
+        {
+            unique_lock<mutex> lk(lock);
+            while ((j->node = pick(k)) == -2) {
+                lk.unlock();
+                ran = xbRunOne(xbPool(), xbWorkerId());   /* Run a queued job meanwhile */
+                lk.lock();
+                if (!ran) done.wait(lk, [&]() { return (j->node = pick(k)) != -2; });
+            }
+            freec -= k;
+            if (j->node >= 0)
+                take[id][j->node] = k;
+            else
+                for (left = k, n = 0; n < nnodes && left > 0; n++) {   /* Spread */
+                    take[id][n] = min(left, nodefree[n]);
+                    left -= take[id][n];
+                }
+            for (n = 0; n < nnodes; n++) nodefree[n] -= take[id][n];
+        }
+        xbSpawn(&g, [&, j, k, id]() {
+            int n, status;
+            double start = clsClock();
+            cpu_set_t saved;
+            string cmd = j->cmd + " -threads " + to_string(k) +
+                         (logs ? " > xbbatch_" + to_string(id + 1) + ".log 2>&1" : " > /dev/null 2>&1");
+
+            if (j->node >= 0) xbNumaPin(nm, j->node, &saved);   /* Inherited by the solver */
+            status = system(cmd.c_str());
+            if (j->node >= 0) xbNumaRestore(&saved);
+            lock_guard<mutex> lk(lock);
+            j->cached = (WIFEXITED(status) && WEXITSTATUS(status) == XBCACHEHIT);
+            j->sec = (status == 0 || j->cached ? clsClock() - start : -1);
+            freec += k;
+            for (n = 0; n < nnodes; n++) nodefree[n] += take[id][n];
+            done.notify_all();
+        });
+    }
+    xbWait(&g);
+    return clsClock() - t0;
+}
+
+/*  Jobs and utilization (busy core-seconds per core and second) per node */
+void nodeReport(const XBNuma *nm, double makespan) {
+    int i, n, njobs;
+    double busy;
+
+    for (n = -1; n < xbNumaNodes(nm); n++) {
+        for (njobs = 0, busy = 0, i = 0; i < (int) JOBS.size(); i++)
+            if (JOBS[i].node == n && JOBS[i].sec >= 0) {
+                njobs++;
+                busy += JOBS[i].sec * JOBS[i].threads;
+            }
+        if (n < 0 && njobs == 0) continue;
+        if (n < 0)
+            cout << "Unpinned: " << njobs << " jobs" << endl;
+        else
+            cout << "Node " << n << " (" << nm->cpus[n].size() << " cores): " << njobs << " jobs, utilization "
+                 << 100 * busy / (nm->cpus[n].size() * max(1e-9, makespan)) << "%" << endl;
+    }
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, ncores = xbNumThreads(), dry = 0, logs = 0, nfail = 0, numa = 0;
+    double t0, actual, plpt, pfifo, mlpt, mfifo;
+    const char *jobfile = NULL, *histfile = "xbbatch.hist";
+    vector<int> lpt, fifo, threads, ones;
+    vector<double> dur, dur1;
+    XBNuma nm;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-cores") && i + 1 < argc)
+            ncores = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-hist") && i + 1 < argc)
+            histfile = argv[++i];
+        else if (!strcmp(argv[i], "-dry"))
+            dry = 1;
+        else if (!strcmp(argv[i], "-logs"))
+            logs = 1;
+        else if (!strcmp(argv[i], "-numa"))
+            numa = 1;
+        else
+            jobfile = argv[i];
+    }
+    if (jobfile == NULL) {
+        cout << "Usage: xbbatch jobfile [-cores n | -numa] [-hist file] [-dry] [-logs]" << endl;
+        return 1;
+    }
+    if (readJobs(jobfile) == 0) {
+        cout << "No jobs in " << jobfile << endl;
+        return 1;
+    }
+    readHistory(histfile);
+    if (numa)
+        for (xbNumaInit(&nm), ncores = 0, i = 0; i < xbNumaNodes(&nm); i++) ncores += (int) nm.cpus[i].size();
+
+    t0 = clsClock();                             /* Predict */
+    for (i = 0; i < (int) JOBS.size(); i++) {
+        getFeatures(JOBS[i]);
+        predict(JOBS[i]);
+    }
+    allocThreads(ncores);
+    clsRecord(&stats, "prediction", clsClock() - t0, (long) JOBS.size());
+
+    for (i = 0; i < (int) JOBS.size(); i++) {
+        fifo.push_back(i);
+        lpt.push_back(i);
+        threads.push_back(JOBS[i].threads);
+        ones.push_back(1);
+        dur.push_back(JOBS[i].pred * speed(JOBS[i].threads));
+        dur1.push_back(JOBS[i].pred);
+    }
+    stable_sort(lpt.begin(), lpt.end(), [&](int a, int b) { return dur[a] > dur[b]; });
+    plpt = makespan(lpt, threads, dur, ncores);
+    pfifo = makespan(fifo, ones, dur1, ncores);
+
+    cout << JOBS.size() << " jobs on " << ncores << " cores, " << HIST.size() << " runs in the history" << endl;
+    cout << "  job  predicted  threads  (based on)  command" << endl;
+    for (i = 0; i < (int) lpt.size(); i++) {
+        Job &j = JOBS[lpt[i]];
+        cout << setw(5) << lpt[i] + 1 << setw(11) << dur[lpt[i]] << setw(9) << j.threads << "  (" << j.source
+             << ")  " << j.cmd << endl;
+    }
+    cout << "Predicted makespan: " << plpt << " sec, in file order on one thread each " << pfifo << " sec"
+         << endl;
+    if (dry) return 0;
+
+    actual = runJobs(lpt, ncores, logs, numa ? &nm : NULL);
+    clsRecord(&stats, "jobs", actual, (long) JOBS.size());
+
+    for (i = 0; i < (int) JOBS.size(); i++) {   /* Measured times */
+        if (JOBS[i].sec < 0) {
+            cout << "Job " << i + 1 << " failed: " << JOBS[i].cmd << endl;
+            nfail++;
+            dur[i] = dur1[i] = 0;
+            continue;
+        }
+        if (JOBS[i].cached)
+            cout << "Job " << i + 1 << " answered from the cache: " << JOBS[i].cmd << endl;
+        else
+            appendHistory(histfile, JOBS[i]);
+        dur[i] = JOBS[i].sec;
+        dur1[i] = JOBS[i].sec / speed(JOBS[i].threads);
+    }
+    mlpt = makespan(lpt, threads, dur, ncores);
+    mfifo = makespan(fifo, ones, dur1, ncores);
+    cout << "Makespan: " << actual << " sec (predicted " << plpt << ", simulated " << mlpt << ")" << endl;
+    cout << "In file order on one thread each: " << mfifo << " sec (simulated), improvement "
+         << 100 * (mfifo - actual) / max(1e-9, mfifo) << "%" << endl;
+    if (numa) nodeReport(&nm, actual);
+    if (nfail > 0) cout << nfail << " jobs failed" << endl;
+    clsPrintStats(&stats);
+
+    return nfail > 0;
+}
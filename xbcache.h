@@ -0,0 +1,234 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbcache.h
+  ``````````````
+  Persistent solution cache for repeated instances.
+
+  The solver describes an instance by a canonical key:
+  a vector of doubles that does not depend on the order
+  of the input (e.g. the widths sorted with their
+  demands) and includes the settings that change the
+  result (engine, optimizer controls). The
+  cache maps the key to a solution vector of the solver.
+
+  The cache is a file mapped into memory: a header with
+  the statistics and XBCACHESLOTS slots of fixed size,
+  each holding the hash of the key, the time of its last
+  use (a counter), the key and the solution. A lookup
+  compares the hashes of all slots and the full key of a
+  slot with the same hash, so a hit is exact. A new
+  solution goes to a free slot or replaces the least
+  recently used one. Keys and solutions longer than a
+  slot are not cached. Several processes may share the
+  file: every access holds an exclusive lock on it.
+
+  The solver checks a hit against the instance (e.g.
+  that a plan meets the demand) before using it and
+  drops a solution that fails (xbCacheDrop). A solver
+  answered from the cache exits with status XBCACHEHIT,
+  so that tools timing the solvers (xbtune.cxx,
+  xbbatch.cxx) do not take the run for a solve.
+********************************************************/
+
+#ifndef XBCACHE_H
+#define XBCACHE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#define XBCACHEMAGIC 0x31434258u        /* "XBC1" */
+#define XBCACHESLOTS 256                /* Entries */
+#define XBCACHESLOTLEN 2046             /* Doubles per entry (key + solution) */
+#define XBCACHEHIT 3                    /* Exit status of a run answered from the cache */
+
+typedef struct {
+    uint32_t magic, nslots, slotlen, pad;
+    uint64_t clock;                     /* Use counter */
+    uint64_t hits, misses, inserts, evictions, drops;
+} XBCacheHeader;
+
+typedef struct {
+    uint64_t hash;                      /* 0: free slot */
+    uint64_t lastuse;
+    int32_t keylen, sollen;
+    double data[XBCACHESLOTLEN];        /* Key followed by the solution */
+} XBCacheSlot;
+
+typedef struct {
+    int fd;                             /* -1 if not open */
+    XBCacheHeader *hdr;
+    XBCacheSlot *slot;
+} XBCache;
+
+/* FNV-1a over the key; -0 and 0 hash alike, 0 is kept for free slots */
+static inline uint64_t xbCacheHash(const std::vector<double> &key) {
+    size_t i, k;
+    double v;
+    unsigned char b[sizeof(double)];
+    uint64_t h = 14695981039346656037ull;
+
+    for (i = 0; i < key.size(); i++) {
+        v = (key[i] == 0 ? 0.0 : key[i]);
+        memcpy(b, &v, sizeof(v));
+        for (k = 0; k < sizeof(b); k++) h = (h ^ b[k]) * 1099511628211ull;
+    }
+    return h == 0 ? 1 : h;
+}
+
+/* Append a string to a key as its 32-bit FNV-1a hash (exact in a double) */
+static inline void xbCacheKeyString(std::vector<double> *key, const std::string &s) {
+    size_t k;
+    uint32_t h = 2166136261u;
+
+    for (k = 0; k < s.size(); k++) h = (h ^ (unsigned char) s[k]) * 16777619u;
+    key->push_back((double) h);
+}
+
+/**************************************************************************/
+/* Open or create the cache file fname. A file of another layout is       */
+/* cleared. Return value: 0 if the cache cannot be used                   */
+/**************************************************************************/
+static inline int xbCacheOpen(XBCache *c, const char *fname) {
+    size_t size = sizeof(XBCacheHeader) + (size_t) XBCACHESLOTS * sizeof(XBCacheSlot);
+    struct stat st;
+    void *base;
+
+    c->fd = open(fname, O_RDWR | O_CREAT, 0644);
+    if (c->fd < 0) return 0;
+    flock(c->fd, LOCK_EX);
+    if (fstat(c->fd, &st) < 0 || ((size_t) st.st_size != size && ftruncate(c->fd, size) < 0)) {
+        flock(c->fd, LOCK_UN);
+        close(c->fd);
+        c->fd = -1;
+        return 0;
+    }
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, 0);
+    if (base == MAP_FAILED) {
+        flock(c->fd, LOCK_UN);
+        close(c->fd);
+        c->fd = -1;
+        return 0;
+    }
+    c->hdr = (XBCacheHeader *) base;
+    c->slot = (XBCacheSlot *) ((char *) base + sizeof(XBCacheHeader));
+    if (c->hdr->magic != XBCACHEMAGIC || c->hdr->nslots != XBCACHESLOTS || c->hdr->slotlen != XBCACHESLOTLEN) {
+        memset(base, 0, size);          /* New or foreign file */
+        c->hdr->magic = XBCACHEMAGIC;
+        c->hdr->nslots = XBCACHESLOTS;
+        c->hdr->slotlen = XBCACHESLOTLEN;
+    }
+    flock(c->fd, LOCK_UN);
+    return 1;
+}
+
+static inline void xbCacheClose(XBCache *c) {
+    if (c->fd < 0) return;
+    munmap(c->hdr, sizeof(XBCacheHeader) + (size_t) XBCACHESLOTS * sizeof(XBCacheSlot));
+    close(c->fd);
+    c->fd = -1;
+}
+
+/* Slot holding key (hash h), -1 if none; the caller holds the lock */
+static inline int xbCacheFind(const XBCache *c, const std::vector<double> &key, uint64_t h) {
+    int k, i;
+    const XBCacheSlot *s;
+
+    for (k = 0; k < XBCACHESLOTS; k++) {
+        s = &c->slot[k];
+        if (s->hash != h || s->keylen != (int) key.size()) continue;
+        for (i = 0; i < s->keylen && s->data[i] == key[i]; i++);
+        if (i == s->keylen) return k;
+    }
+    return -1;
+}
+
+/**************************************************************************/
+/* Look up the solution of key.                                           */
+/* Return value: 1 and the solution in sol on a hit, 0 otherwise          */
+/**************************************************************************/
+static inline int xbCacheLookup(XBCache *c, const std::vector<double> &key, std::vector<double> *sol) {
+    int k;
+    XBCacheSlot *s;
+
+    if (c->fd < 0) return 0;
+    flock(c->fd, LOCK_EX);
+    k = xbCacheFind(c, key, xbCacheHash(key));
+    if (k < 0)
+        c->hdr->misses++;
+    else {
+        s = &c->slot[k];
+        s->lastuse = ++c->hdr->clock;
+        sol->assign(s->data + s->keylen, s->data + s->keylen + s->sollen);
+        c->hdr->hits++;
+    }
+    flock(c->fd, LOCK_UN);
+    return k >= 0;
+}
+
+/* Store the solution of key, replacing the least recently used entry */
+static inline void xbCacheStore(XBCache *c, const std::vector<double> &key, const std::vector<double> &sol) {
+    int k, lru;
+    uint64_t h = xbCacheHash(key);
+    XBCacheSlot *s;
+
+    if (c->fd < 0 || key.size() + sol.size() > XBCACHESLOTLEN) return;
+    flock(c->fd, LOCK_EX);
+    if ((k = xbCacheFind(c, key, h)) < 0) {
+        for (lru = 0, k = 0; k < XBCACHESLOTS && c->slot[k].hash != 0; k++)
+            if (c->slot[k].lastuse < c->slot[lru].lastuse) lru = k;
+        if (k == XBCACHESLOTS) {        /* Full: evict */
+            k = lru;
+            c->hdr->evictions++;
+        }
+        c->hdr->inserts++;
+    }
+    s = &c->slot[k];
+    s->hash = h;
+    s->lastuse = ++c->hdr->clock;
+    s->keylen = (int32_t) key.size();
+    s->sollen = (int32_t) sol.size();
+    if (!key.empty()) memcpy(s->data, &key[0], key.size() * sizeof(double));
+    if (!sol.empty()) memcpy(s->data + key.size(), &sol[0], sol.size() * sizeof(double));
+    flock(c->fd, LOCK_UN);
+}
+
+/* Remove the entry of key, e.g. after its solution failed the check */
+static inline void xbCacheDrop(XBCache *c, const std::vector<double> &key) {
+    int k;
+
+    if (c->fd < 0) return;
+    flock(c->fd, LOCK_EX);
+    if ((k = xbCacheFind(c, key, xbCacheHash(key))) >= 0) {
+        c->slot[k].hash = 0;
+        c->slot[k].lastuse = 0;
+        c->hdr->drops++;
+        c->hdr->hits--;                 /* Not a hit after all */
+        c->hdr->misses++;
+    }
+    flock(c->fd, LOCK_UN);
+}
+
+static inline void xbCachePrintStats(const XBCache *c) {
+    int k, n = 0;
+    uint64_t look;
+
+    if (c->fd < 0) return;
+    for (k = 0; k < XBCACHESLOTS; k++)
+        if (c->slot[k].hash != 0) n++;
+    look = c->hdr->hits + c->hdr->misses;
+    std::cout << "Solution cache: " << n << " of " << XBCACHESLOTS << " entries, " << c->hdr->hits
+              << " hits in " << look << " lookups (" << (look > 0 ? 100.0 * c->hdr->hits / look : 0.0)
+              << "%), " << c->hdr->evictions << " evictions, " << c->hdr->drops << " dropped" << std::endl;
+}
+
+#endif
@@ -0,0 +1,337 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbccels.cxx
+  ````````````````
+  Chance-constrained economic lot sizing: the plan of
+  one item (setups y[t], production x[t], cumulative
+  production P[t]) has to serve the whole demand of at
+  least (1-eps) of N demand scenarios. With z[s] = 1 if
+  scenario s may be left unserved:
+    sum(s) z[s] <= k = floor(eps*N)
+    P[t] + M[s][t]*z[s] >= D[s][t]    for all s, t
+  where D[s][t] is the cumulative demand of scenario s.
+  The cost is the setup cost plus the holding cost of
+  the stock over the mean demand.
+
+  Quantile tightening: at most k scenarios are unserved,
+  so P[t] is at least the (k+1)-th largest D[s][t], Q[t].
+  With P[t] >= Q[t] in the model M[s][t] = D[s][t]-Q[t]
+  suffices, and the rows with D[s][t] <= Q[t] are
+  implied and never needed.
+
+  The scenario rows are lazy constraints: the model
+  starts with the quantile bounds and the budget row
+  only. At every node the LP solution is checked
+  scenario by scenario (in parallel for many scenarios)
+  and the most violated row of each violated scenario
+  is added as a cut, at most MAXLAZY per node; integer
+  solutions that violate a scenario row (e.g. from the
+  heuristics) are rejected. Presolve and dual
+  reductions are off because the optimizer does not see
+  the rows that are not yet added. With -full all rows
+  are in the model from the start, for comparison.
+
+  The optimizer threads come from the core budget of the
+  scheduler (see xbthreads.h), so the separation inside
+  the callbacks uses only the cores the optimizer leaves
+  free and otherwise runs on the calling thread.
+
+  Usage: xbccels [datafile | -gen N T util seed] [-item i]
+                 [-cv x] [-scen n] [-eps x] [-maxtime sec]
+                 [-threads n] [-full]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbscen.h"
+#include "xbthreads.h"
+
+using namespace std;
+using namespace ::dashoptimization;
+
+#define EPS    1e-6
+
+#define MAXLAZY 200            /* Max. number of scenario rows per node */
+#define SEPGRAIN 256           /* Scenarios per separation chunk */
+#define NTEST 20000            /* Scenarios of the out-of-sample test */
+
+/****DATA****/
+CLSData DT;                             /* Demand series and costs */
+int ITEM = 0;                           /* Item of the data used */
+int T;                                  /* Number of periods */
+vector<double> MEAN;                    /* Mean demand per period */
+double SETUPC, HOLDC;                   /* Setup and holding cost */
+double CV = 0.3;                        /* Variation coefficient of demand */
+double EPSILON = 0.05;                  /* Share of scenarios left unserved */
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+
+ScenSet SC;                             /* Scenarios */
+vector<double> DCUM;                    /* DCUM[s*T+t]: cumulative demand */
+vector<double> Q;                       /* Q[t]: quantile bound of P[t] */
+int K;                                  /* Max. number of unserved scenarios */
+
+vector<XPRBvar> y, x, P, z;             /* Setup, production, cum. production,
+                                           scenario unserved */
+XPRBprob p("CCEls");                    /* Initialize a new problem in BCL */
+
+vector<int> COLP, COLZ;                 /* Column numbers of P and z */
+atomic<long> nlazy(0), nreject(0);      /* Rows added, solutions rejected */
+CLSStats stats;
+
+/***********************************************************************/
+
+/*  Cumulative demands and quantile bounds */
+void calcQuantiles() {
+    int s, t, N = SC.nscen;
+    double D;
+    vector<double> col(N);
+
+    DCUM.resize((size_t) N * T);
+    for (s = 0; s < N; s++)
+        for (D = 0, t = 0; t < T; t++) {
+            D += SC.dem[(size_t) t * SC.S + s];
+            DCUM[(size_t) s * T + t] = D;
+        }
+    Q.resize(T);
+    for (t = 0; t < T; t++) {
+        for (s = 0; s < N; s++) col[s] = DCUM[(size_t) s * T + t];
+        nth_element(col.begin(), col.begin() + K, col.end(), greater<double>());
+        Q[t] = col[K];                  /* (K+1)-th largest */
+    }
+}
+
+void modCCEls(int full) {
+    int s, t, N = SC.nscen;
+    double M, D;
+    XPRBexpr cobj, le;
+
+    y.resize(T);
+    x.resize(T);
+    P.resize(T);
+    z.resize(N);
+    for (t = 0; t < T; t++) {
+        y[t] = p.newVar(XPRBnewname("y%d", t + 1), XPRB_BV);
+        x[t] = p.newVar(XPRBnewname("x%d", t + 1));
+        P[t] = p.newVar(XPRBnewname("P%d", t + 1));
+    }
+    for (s = 0; s < N; s++)
+        z[s] = p.newVar(XPRBnewname("z%d", s + 1), XPRB_BV);
+
+    for (t = 0; t < T; t++)                       /* Minimize total cost */
+        cobj += SETUPC * y[t] + HOLDC * P[t];
+    p.setObj(cobj);                 /* The mean demand part is a constant */
+
+    for (M = 0, s = 0; s < N; s++) M = max(M, DCUM[(size_t) s * T + T - 1]);
+    for (t = 0; t < T; t++) {
+        p.newCtr("Setup", x[t] <= M * y[t]);
+        le = P[t] - x[t];
+        if (t > 0) le -= P[t - 1];
+        p.newCtr("Cum", le == 0);
+        p.newCtr("Quantile", P[t] >= Q[t]);
+    }
+    le = 0;
+    for (s = 0; s < N; s++) le += z[s];
+    p.newCtr("Budget", le <= K);
+
+    if (full)                                     /* All scenario rows */
+        for (s = 0; s < N; s++)
+            for (t = 0; t < T; t++) {
+                D = DCUM[(size_t) s * T + t];
+                if (D > Q[t] + EPS) p.newCtr("Scen", P[t] + (D - Q[t]) * z[s] >= D);
+            }
+}
+
+/**************************************************************************/
+/*  Most violated scenario row per scenario for the solution sol;         */
+/*  viol[s] > 0 and per[s] = t if the row of (s,t) is violated            */
+/**************************************************************************/
+void separate(const vector<double> &sol, vector<double> &viol, vector<int> &per) {
+    int N = SC.nscen;
+
+    viol.assign(N, 0);
+    per.assign(N, -1);
+    xbParallelChunks(N, SEPGRAIN, N >= 4 * SEPGRAIN ? NTHREADS : 1, [&](int lo, int hi, int c) {
+        int s, t;
+        double v, d, zs;
+
+        for (s = lo; s < hi; s++) {
+            zs = sol[COLZ[s]];
+            if (zs > 1 - EPS) continue;         /* Scenario given up */
+            for (t = 0; t < T; t++) {
+                d = DCUM[(size_t) s * T + t];
+                v = d - sol[COLP[t]] - max(0.0, d - Q[t]) * zs;
+                if (v > viol[s]) {
+                    viol[s] = v;
+                    per[s] = t;
+                }
+            }
+        }
+    });
+}
+
+/**************************************************************************/
+/*  Node callback: add the violated scenario rows as cuts                 */
+/**************************************************************************/
+void XPRS_CC cbLazy(XPRSprob xprob, void *data, int *feas) {
+    int k, s, ncol, n;
+    vector<double> sol, viol, rhs, vals;
+    vector<int> per, order, type, start(1, 0), cols;
+    vector<char> sense;
+
+    if (*feas) return;                           /* Node is infeasible */
+    XPRSgetintattrib(xprob, XPRS_COLS, &ncol);
+    sol.resize(ncol);
+    XPRSgetlpsol(xprob, &sol[0], NULL, NULL, NULL);
+    separate(sol, viol, per);
+    for (s = 0; s < SC.nscen; s++)
+        if (viol[s] > EPS) order.push_back(s);
+    if (order.empty()) return;
+    n = min((int) order.size(), MAXLAZY);
+    partial_sort(order.begin(), order.begin() + n, order.end(), [&](int a, int b) { return viol[a] > viol[b]; });
+
+    for (k = 0; k < n; k++) {                    /* P[t] + M*z[s] >= D */
+        s = order[k];
+        cols.push_back(COLP[per[s]]);
+        vals.push_back(1);
+        cols.push_back(COLZ[s]);
+        vals.push_back(DCUM[(size_t) s * T + per[s]] - Q[per[s]]);
+        start.push_back((int) cols.size());
+        type.push_back(1);
+        sense.push_back('G');
+        rhs.push_back(DCUM[(size_t) s * T + per[s]]);
+    }
+    XPRSaddcuts(xprob, n, &type[0], &sense[0], &rhs[0], &start[0], &cols[0], &vals[0]);
+    nlazy += n;
+}
+
+/*  Reject integer solutions that violate a scenario row */
+void XPRS_CC cbCheckSol(XPRSprob xprob, void *data, int soltype, int *reject, double *cutoff) {
+    int s, ncol;
+    vector<double> sol, viol;
+    vector<int> per;
+
+    XPRSgetintattrib(xprob, XPRS_COLS, &ncol);
+    sol.resize(ncol);
+    XPRSgetlpsol(xprob, &sol[0], NULL, NULL, NULL);
+    separate(sol, viol, per);
+    for (s = 0; s < SC.nscen; s++)
+        if (viol[s] > EPS) {
+            *reject = 1;
+            nreject++;
+            return;
+        }
+}
+
+void solveCCEls(int maxtime, int full) {
+    int s, t, nopt, nserved = 0;
+    double t0, cost, D;
+    vector<double> prod(T);
+    XPRSprob xprob = p.getXPRSprob();
+    ScenSet test;
+    ScenResult res;
+
+    p.loadMat();
+    COLP.resize(T);
+    COLZ.resize(SC.nscen);
+    for (t = 0; t < T; t++) COLP[t] = P[t].getColNum();
+    for (s = 0; s < SC.nscen; s++) COLZ[s] = z[s].getColNum();
+    if (!full) {
+        XPRSsetintcontrol(xprob, XPRS_PRESOLVE, 0);
+        XPRSsetintcontrol(xprob, XPRS_MIPPRESOLVE, 0);
+        XPRSsetintcontrol(xprob, XPRS_MIPDUALREDUCTIONS, 0);
+        XPRSaddcboptnode(xprob, cbLazy, NULL, 0);
+        XPRSaddcbpreintsol(xprob, cbCheckSol, NULL, 0);
+    }
+    if (maxtime > 0)
+        XPRSsetintcontrol(xprob, XPRS_MAXTIME, -maxtime);
+
+    nopt = xbAcquireCores(NTHREADS > 0 ? NTHREADS : xbNumThreads());
+    XPRSsetintcontrol(xprob, XPRS_THREADS, nopt);
+
+    t0 = clsClock();
+    p.mipOptimize("");
+    xbReleaseCores(nopt);
+    clsRecord(&stats, full ? "full MIP" : "lazy MIP", clsClock() - t0, nlazy.load());
+    if (!full) clsRecord(&stats, "rejected solutions", 0, nreject.load());
+    if (p.getMIPStat() != XPRB_MIP_OPTIMAL && p.getMIPStat() != XPRB_MIP_SOLUTION) {
+        cout << "No solution found." << endl;
+        return;
+    }
+
+    cost = p.getObjVal();                        /* Stock over the mean demand */
+    for (D = 0, t = 0; t < T; t++) {
+        prod[t] = x[t].getSol();
+        D += MEAN[t];
+        cost -= HOLDC * D;
+    }
+    for (s = 0; s < SC.nscen; s++) {             /* Check all scenarios */
+        for (t = 0; t < T && P[t].getSol() >= DCUM[(size_t) s * T + t] - 1e-4; t++);
+        if (t == T) nserved++;
+    }
+    scenGenerate(&test, T, NTEST, &MEAN[0], CV, 2);
+    res = scenEvaluate(&test, &prod[0], HOLDC, 0, NULL);
+
+    cout << "Cost " << cost << " (" << (full ? "all rows" : "lazy rows") << ", " << nlazy.load()
+         << " rows added)" << endl;
+    cout << "Scenarios served: " << nserved << " of " << SC.nscen << " (target " << SC.nscen - K
+         << "), out of sample " << 100 * res.service << "%" << endl;
+    cout << "Setups:";
+    for (t = 0; t < T; t++)
+        if (y[t].getSol() > 0.5) cout << " " << t + 1;
+    cout << endl;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, nscen = 1000, maxtime = 0, full = 0;
+
+    clsGenerate(&DT, 1, 52, 0.8, 1);
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-item") && i + 1 < argc)
+            ITEM = atoi(argv[++i]) - 1;
+        else if (!strcmp(argv[i], "-cv") && i + 1 < argc)
+            CV = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-scen") && i + 1 < argc)
+            nscen = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-eps") && i + 1 < argc)
+            EPSILON = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-full"))
+            full = 1;
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    if (ITEM < 0 || ITEM >= DT.N) ITEM = 0;
+    T = DT.T;
+    MEAN.assign(DT.dem.begin() + ITEM * T, DT.dem.begin() + (ITEM + 1) * T);
+    SETUPC = DT.setupc[ITEM];
+    HOLDC = DT.holdc[ITEM];
+
+    scenGenerate(&SC, T, nscen, &MEAN[0], CV, 1);
+    K = min(nscen - 1, (int) floor(EPSILON * nscen));
+    calcQuantiles();
+    modCCEls(full);
+    solveCCEls(maxtime, full);
+    clsPrintStats(&stats);
+
+    return 0;
+}
@@ -0,0 +1,789 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbcls.cxx
+  ``````````````
+  Multi-item capacitated lot sizing with setup times
+  and setup carryover, solved by adding valid
+  inequalities in several rounds looping over the root
+  node, followed by a relax-and-fix heuristic.
+
+  Setups consume capacity. The setup state of at most
+  one item per period can be carried over from the
+  previous period (w[i][t] = 1), in which case the item
+  can be produced without a new setup. Carrying it over
+  a whole period requires that no other item is set up
+  in that period (q[i][t] = 1).
+
+  Valid inequalities separated at the root:
+    (l,S)-inequalities with carryover, per item i:
+      sum(t in S) x[i][t] <= sum(t in S) D[i][t][l]*(y[i][t]+w[i][t]) + s[i][l]
+    setup time VUBs, per item and period:
+      ptime[i]*x[i][t] + stime[i]*y[i][t] <= cap[t]*(y[i][t]+w[i][t])
+    lifted flow covers on the capacity row of period t,
+    with the flows f[i] = ptime[i]*x[i][t] + stime[i]*y[i][t],
+    f[i] <= m[i]*z[i], z[i] = y[i][t]+w[i][t], a cover C
+    with lambda = sum(i in C) m[i] - cap[t] > 0 and the
+    items L outside the cover:
+      sum(i in C) f[i] + (m[i]-lambda)^+ * (1-z[i])
+      + sum(j in L) f[j] - (m[j]-g(m[j]))*z[j] <= cap[t]
+    where g is the lifting function of the cover
+    covers of the setup time knapsack of period t,
+    extended by the items with larger setup time:
+      sum(i in E(K)) y[i][t] <= |K|-1
+
+  The flow cover and cover separators also run at every
+  node of the relax-and-fix MIPs through the optimizer
+  node callback.
+
+  With -dw the model without setup carryover is solved
+  by Dantzig-Wolfe column generation instead: a column
+  is the full production plan of one item, the master
+  keeps one convexity row per item and the capacity
+  rows. Pricing is a Wagner-Whitin DP per item (see
+  xbww.h) with setup cost setupc - pi[t]*stime and unit
+  cost -pi[t]*ptime under the capacity duals pi[t]; the
+  items are priced in parallel (see xbdw.h). Its Lagrangian bound is
+  compared with the bound of the cut loop on the same
+  model, and the master MIP over the generated plans
+  gives a solution.
+
+  With -alns sec the relax-and-fix solution is improved
+  by adaptive large neighborhood search (see xbalns.h)
+  for sec seconds: the operators free the setups of a
+  window of periods, of a set of items or of random
+  item-periods; all other setups are fixed to the
+  incumbent by their bounds and the MIP is re-solved
+  warm within a time box of ALNSTIMEBOX seconds.
+
+  With -threads n the optimizer runs use n threads, as
+  does the pricing. -features prints the instance
+  features used by the batch scheduler (xbbatch.cxx)
+  and stops.
+
+  Usage: xbcls [datafile | -gen N T util seed] [-maxtime sec]
+               [-nocarry] [-dw] [-threads n] [-alns sec]
+               [-features]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbww.h"
+#include "xbthreads.h"
+#include "xbalns.h"
+#include "xbdw.h"
+
+using namespace std;
+using namespace ::dashoptimization;
+
+#define EPS    1e-6
+
+#define MAXPASS 50             /* Max. number of cut rounds */
+#define MINIMPROVE 1e-4        /* Stop when a round improves less (rel.) */
+#define RFWINDOW 5             /* Periods per relax-and-fix window */
+#define MAXROOTGAP 0.05        /* Root gap target */
+#define DWGRAIN 8              /* Items per pricing chunk */
+#define MAXNODECUTS 100        /* Max. number of cuts per node */
+#define ALNSTIMEBOX 5          /* Max. time per neighborhood (sec) */
+#define ALNSFREE 0.1           /* Initial share of setups freed */
+
+#define IT(i, t) ((i) * DT.T + (t))
+
+/****DATA****/
+CLSData DT;                             /* Instance data */
+vector<double> DC;                      /* DC[IT(i,t)]: demand of i in t..T-1 */
+
+vector<XPRBvar> x;                      /* Production of item i in period t */
+vector<XPRBvar> s;                      /* Stock of item i at the end of t */
+vector<XPRBvar> y;                      /* Setup of item i in period t */
+vector<XPRBvar> w;                      /* Setup of i carried over into t */
+vector<XPRBvar> q;                      /* Setup of i carried through t */
+
+XPRBprob p("Cls");                      /* Initialize a new problem in BCL */
+
+CLSStats stats;                         /* Timings and counters */
+int ncut = 0;                           /* Number of cuts added */
+int CARRY = 1;                          /* Allow setup carryover */
+atomic<long> nodecuts(0);               /* Cuts added in the node callback */
+vector<int> COLX, COLY, COLW;           /* Column numbers of x, y and w */
+
+typedef struct {                        /* Cut sum(coef*var) <= rhs */
+    vector<XPRBvar> var;
+    vector<double> coef;
+    double rhs;
+} CLSCut;
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+int ALNSTIME = 0;                       /* Time for ALNS (sec), 0 for none */
+vector<int> INC;                        /* Setups of the heuristic solution:
+                                           y, w, q of item-period k at 3k.. */
+
+DWMaster DW;                            /* Plans of the items (xbdw.h) */
+XPRBprob pdw("ClsDW");                  /* Dantzig-Wolfe master */
+
+/***********************************************************************/
+
+void modCls() {
+    int i, k, t, N = DT.N, T = DT.T;
+    XPRBexpr cobj, le;
+
+    DC.assign(N * T, 0);
+    for (i = 0; i < N; i++)
+        for (t = T - 1; t >= 0; t--)
+            DC[IT(i, t)] = DT.dem[IT(i, t)] + (t < T - 1 ? DC[IT(i, t + 1)] : 0);
+
+/****VARIABLES****/
+    x.resize(N * T);
+    s.resize(N * T);
+    y.resize(N * T);
+    w.resize(N * T);
+    q.resize(N * T);
+    for (i = 0; i < N; i++)
+        for (t = 0; t < T; t++) {
+            x[IT(i, t)] = p.newVar(XPRBnewname("x%d_%d", i + 1, t + 1));
+            s[IT(i, t)] = p.newVar(XPRBnewname("s%d_%d", i + 1, t + 1));
+            y[IT(i, t)] = p.newVar(XPRBnewname("y%d_%d", i + 1, t + 1), XPRB_BV);
+            w[IT(i, t)] = p.newVar(XPRBnewname("w%d_%d", i + 1, t + 1), XPRB_BV, 0, t > 0 && CARRY ? 1 : 0);
+            q[IT(i, t)] = p.newVar(XPRBnewname("q%d_%d", i + 1, t + 1), XPRB_BV);
+        }
+
+/****OBJECTIVE****/
+    for (i = 0; i < N; i++)                       /* Minimize total cost */
+        for (t = 0; t < T; t++)
+            cobj += DT.setupc[i] * y[IT(i, t)] + DT.holdc[i] * s[IT(i, t)];
+    p.setObj(cobj);
+
+/****CONSTRAINTS****/
+    for (i = 0; i < N; i++)
+        for (t = 0; t < T; t++) {
+            /* Stock balance */
+            if (t > 0)
+                p.newCtr("Balance", s[IT(i, t - 1)] + x[IT(i, t)] == DT.dem[IT(i, t)] + s[IT(i, t)]);
+            else
+                p.newCtr("Balance", x[IT(i, t)] == DT.dem[IT(i, t)] + s[IT(i, t)]);
+
+            /* Production needs a setup or a carried over setup state; a
+               setup leaves less capacity than a carried over one */
+            p.newCtr("Produce", x[IT(i, t)] <=
+                     min(DC[IT(i, t)], (DT.cap[t] - DT.stime[i]) / DT.ptime[i]) * y[IT(i, t)] +
+                     min(DC[IT(i, t)], DT.cap[t] / DT.ptime[i]) * w[IT(i, t)]);
+            p.newCtr("OneSetup", y[IT(i, t)] + w[IT(i, t)] <= 1);
+
+            /* The carried over state must exist at the end of t-1 */
+            if (t > 0)
+                p.newCtr("Carry", w[IT(i, t)] <= y[IT(i, t - 1)] + w[IT(i, t - 1)]);
+
+            /* Carrying over into t and t+1 keeps the line on i during t */
+            if (t < T - 1) {
+                p.newCtr("Through", w[IT(i, t)] + w[IT(i, t + 1)] <= 1 + q[IT(i, t)]);
+                le = 0;
+                for (k = 0; k < N; k++)
+                    if (k != i) le += y[IT(k, t)];
+                p.newCtr("Alone", le + (N - 1) * q[IT(i, t)] <= N - 1);
+            }
+        }
+
+    for (t = 0; t < T; t++) {
+        le = 0;                                   /* Capacity incl. setup times */
+        for (i = 0; i < N; i++)
+            le += DT.ptime[i] * x[IT(i, t)] + DT.stime[i] * y[IT(i, t)];
+        p.newCtr("Capacity", le <= DT.cap[t]);
+
+        le = 0;                                   /* One carried over setup */
+        for (i = 0; i < N; i++)
+            le += w[IT(i, t)];
+        p.newCtr("CarryOne", le <= 1);
+    }
+}
+
+/**************************************************************************/
+/*  (l,S)-inequalities with carryover for item i: S holds the periods     */
+/*  t <= l where production exceeds D[t][l]*(y+w). Return: cuts added     */
+/**************************************************************************/
+int sepLS(int i, const vector<double> &solx, const vector<double> &sols,
+          const vector<double> &solz) {
+    int t, l, n = 0;
+    double viol, dtl;
+    XPRBexpr le;
+
+    for (l = 0; l < DT.T; l++) {
+        viol = -sols[IT(i, l)];
+        for (t = 0; t <= l; t++) {
+            dtl = DC[IT(i, t)] - DC[IT(i, l)] + DT.dem[IT(i, l)];   /* D[t][l] */
+            if (solx[IT(i, t)] > dtl * solz[IT(i, t)] + EPS) viol += solx[IT(i, t)] - dtl * solz[IT(i, t)];
+        }
+        if (viol > EPS * 100) {
+            le = -1.0 * s[IT(i, l)];
+            for (t = 0; t <= l; t++) {
+                dtl = DC[IT(i, t)] - DC[IT(i, l)] + DT.dem[IT(i, l)];
+                if (solx[IT(i, t)] > dtl * solz[IT(i, t)] + EPS)
+                    le += x[IT(i, t)] - dtl * y[IT(i, t)] - dtl * w[IT(i, t)];
+            }
+            p.newCtr(XPRBnewname("ls%d", ++ncut), le <= 0);
+            n++;
+        }
+    }
+    return n;
+}
+
+/*  Setup time VUB for item i in period t */
+int sepVUB(int i, int t, const vector<double> &solx, const vector<double> &soly,
+           const vector<double> &solz) {
+    if (DT.ptime[i] * solx[IT(i, t)] + DT.stime[i] * soly[IT(i, t)] >
+        DT.cap[t] * solz[IT(i, t)] + EPS * 100) {
+        p.newCtr(XPRBnewname("vub%d", ++ncut), DT.ptime[i] * x[IT(i, t)] + DT.stime[i] * y[IT(i, t)] <=
+                 DT.cap[t] * y[IT(i, t)] + DT.cap[t] * w[IT(i, t)]);
+        return 1;
+    }
+    return 0;
+}
+
+/**************************************************************************/
+/*  Flow bound m of item i in period t: a setup leaves cap-stime, a       */
+/*  carried over setup the whole capacity                                 */
+/**************************************************************************/
+double flowUB(int i, int t) {
+    double uy, uw;
+
+    uy = min(DC[IT(i, t)], (DT.cap[t] - DT.stime[i]) / DT.ptime[i]);
+    uw = min(DC[IT(i, t)], DT.cap[t] / DT.ptime[i]);
+    return max(DT.ptime[i] * uy + DT.stime[i], DT.ptime[i] * uw);
+}
+
+/*  Lifting function of a flow cover: A[h] is the sum of the h largest
+    flow bounds in the cover that exceed lambda */
+double liftFC(double u, const vector<double> &A, double lambda) {
+    int h, r = (int) A.size() - 1;
+
+    for (h = 0; h < r; h++) {
+        if (u <= A[h + 1] - lambda) return h * lambda;
+        if (u <= A[h + 1]) return u - A[h + 1] + (h + 1) * lambda;
+    }
+    return r * lambda;
+}
+
+/**************************************************************************/
+/*  Lifted flow cover for the capacity row of period t. The cover takes   */
+/*  the items by increasing (1-z)/m until it exceeds the capacity; the    */
+/*  items outside the cover are lifted where this adds to the violation.  */
+/*  Return value: number of cuts found                                    */
+/**************************************************************************/
+int sepFlowCover(int t, const vector<double> &solx, const vector<double> &soly,
+                 const vector<double> &solz, vector<CLSCut> &cuts) {
+    int i, k, N = DT.N;
+    double lambda, beta, lhs, sum = 0;
+    vector<double> m(N), f(N), A(1, 0);
+    vector<int> order, incover(N, 0);
+    CLSCut cut;
+
+    for (i = 0; i < N; i++) {
+        m[i] = flowUB(i, t);
+        f[i] = DT.ptime[i] * solx[IT(i, t)] + DT.stime[i] * soly[IT(i, t)];
+        if (solz[IT(i, t)] > EPS) order.push_back(i);
+    }
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return (1 - solz[IT(a, t)]) * m[b] < (1 - solz[IT(b, t)]) * m[a];
+    });
+    for (k = 0; k < (int) order.size() && sum <= DT.cap[t]; k++) {
+        incover[order[k]] = 1;
+        sum += m[order[k]];
+    }
+    if (sum <= DT.cap[t] + EPS) return 0;     /* No cover */
+    lambda = sum - DT.cap[t];
+
+    order.clear();                            /* Flow bounds > lambda, sorted */
+    for (i = 0; i < N; i++)
+        if (incover[i] && m[i] > lambda) order.push_back(i);
+    sort(order.begin(), order.end(), [&](int a, int b) { return m[a] > m[b]; });
+    for (k = 0; k < (int) order.size(); k++)
+        A.push_back(A[k] + m[order[k]]);
+
+    cut.rhs = DT.cap[t];
+    lhs = 0;
+    for (i = 0; i < N; i++) {
+        if (incover[i]) {
+            lhs += f[i] + max(0.0, m[i] - lambda) * (1 - solz[IT(i, t)]);
+            if (m[i] > lambda) cut.rhs -= m[i] - lambda;
+            beta = max(0.0, m[i] - lambda);   /* -beta*(y+w) */
+        } else {
+            beta = m[i] - liftFC(m[i], A, lambda);
+            if (f[i] - beta * solz[IT(i, t)] <= EPS) continue;
+            lhs += f[i] - beta * solz[IT(i, t)];
+        }
+        cut.var.push_back(x[IT(i, t)]);
+        cut.coef.push_back(DT.ptime[i]);
+        cut.var.push_back(y[IT(i, t)]);
+        cut.coef.push_back(DT.stime[i] - beta);
+        if (CARRY && t > 0 && beta > 0) {
+            cut.var.push_back(w[IT(i, t)]);
+            cut.coef.push_back(-beta);
+        }
+    }
+    if (lhs <= DT.cap[t] + EPS * 100) return 0;
+    cuts.push_back(cut);
+    return 1;
+}
+
+/**************************************************************************/
+/*  Cover of the setup time knapsack sum(i) stime[i]*y[i][t] <= cap[t]:   */
+/*  greedy by increasing (1-y)/stime, made minimal and extended.          */
+/*  Return value: number of cuts found                                    */
+/**************************************************************************/
+int sepCover(int t, const vector<double> &soly, vector<CLSCut> &cuts) {
+    int i, k, N = DT.N, nk = 0;
+    double sum = 0, maxst = 0, lhs = 0;
+    vector<int> order, incover(N, 0);
+    CLSCut cut;
+
+    for (i = 0; i < N; i++)
+        if (soly[IT(i, t)] > EPS) order.push_back(i);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return (1 - soly[IT(a, t)]) * DT.stime[b] < (1 - soly[IT(b, t)]) * DT.stime[a];
+    });
+    for (k = 0; k < (int) order.size() && sum <= DT.cap[t]; k++, nk++) {
+        incover[order[k]] = 1;
+        sum += DT.stime[order[k]];
+    }
+    if (sum <= DT.cap[t]) return 0;           /* No cover */
+    for (k = nk - 1; k >= 0; k--)             /* Make it minimal */
+        if (sum - DT.stime[order[k]] > DT.cap[t]) {
+            incover[order[k]] = 0;
+            sum -= DT.stime[order[k]];
+            nk--;
+        }
+
+    for (i = 0; i < N; i++)
+        if (incover[i]) maxst = max(maxst, DT.stime[i]);
+    for (i = 0; i < N; i++)
+        if (incover[i] || DT.stime[i] >= maxst) {
+            lhs += soly[IT(i, t)];
+            cut.var.push_back(y[IT(i, t)]);
+            cut.coef.push_back(1);
+        }
+    cut.rhs = nk - 1;
+    if (lhs <= cut.rhs + EPS * 100) return 0;
+    cuts.push_back(cut);
+    return 1;
+}
+
+/**************************************************************************/
+/*  Node callback: flow cover and cover cuts for the node LP solution     */
+/**************************************************************************/
+void XPRS_CC cbNodeCuts(XPRSprob xprob, void *data, int *feas) {
+    int k, t, ncol, nt = DT.N * DT.T;
+    vector<double> sol, solx(nt), soly(nt), solz(nt), rhs, vals;
+    vector<int> type, start(1, 0), cols;
+    vector<char> sense;
+    vector<CLSCut> cuts;
+
+    if (*feas) return;                           /* Node is infeasible */
+    XPRSgetintattrib(xprob, XPRS_COLS, &ncol);
+    sol.resize(ncol);
+    XPRSgetlpsol(xprob, &sol[0], NULL, NULL, NULL);
+    for (k = 0; k < nt; k++) {
+        solx[k] = sol[COLX[k]];
+        soly[k] = sol[COLY[k]];
+        solz[k] = soly[k] + sol[COLW[k]];
+    }
+
+    for (t = 0; t < DT.T && (int) cuts.size() < MAXNODECUTS; t++) {
+        sepFlowCover(t, solx, soly, solz, cuts);
+        sepCover(t, soly, cuts);
+    }
+    if (cuts.empty()) return;
+
+    for (k = 0; k < (int) cuts.size(); k++) {
+        for (t = 0; t < (int) cuts[k].var.size(); t++) {
+            cols.push_back(cuts[k].var[t].getColNum());
+            vals.push_back(cuts[k].coef[t]);
+        }
+        start.push_back((int) cols.size());
+        type.push_back(1);
+        sense.push_back('L');
+        rhs.push_back(cuts[k].rhs);
+    }
+    XPRSaddcuts(xprob, (int) cuts.size(), &type[0], &sense[0], &rhs[0], &start[0], &cols[0], &vals[0]);
+    nodecuts += (long) cuts.size();
+}
+
+/*  Add the cuts as rows of the problem */
+void addCuts(const vector<CLSCut> &cuts, const char *prefix) {
+    int k, j;
+    XPRBexpr le;
+
+    for (k = 0; k < (int) cuts.size(); k++) {
+        le = 0;
+        for (j = 0; j < (int) cuts[k].var.size(); j++)
+            le += cuts[k].coef[j] * cuts[k].var[j];
+        p.newCtr(XPRBnewname("%s%d", prefix, ++ncut), le <= cuts[k].rhs);
+    }
+}
+
+/**************************************************************************/
+/*  Cut generation loop at the top node:                                  */
+/*    solve the LP and save the basis                                     */
+/*    get the solution values                                             */
+/*    identify and set up violated constraints                            */
+/*    load the modified problem and load the saved basis                  */
+/*  Return value: root bound                                              */
+/**************************************************************************/
+double solveClsRoot() {
+    double objval = 0, last = -XPRB_INFINITY, t0;
+    int i, t, npass, npcut, nls, nvub, nfc, N = DT.N, T = DT.T;
+    vector<double> solx(N * T), sols(N * T), soly(N * T), solz(N * T);
+    vector<CLSCut> fcuts, ccuts;
+    XPRBbasis basis;
+
+    XPRSsetintcontrol(p.getXPRSprob(), XPRS_CUTSTRATEGY, 0);
+    /* Disable automatic cuts - we use our own */
+    XPRSsetintcontrol(p.getXPRSprob(), XPRS_PRESOLVE, 0);
+    /* Switch presolve off */
+
+    for (npass = 1; npass <= MAXPASS; npass++) {
+        t0 = clsClock();
+        p.lpOptimize("");           /* Solve the LP */
+        basis = p.saveBasis();      /* Save the current basis */
+        objval = p.getObjVal();     /* Get the objective value */
+        clsRecord(&stats, "root LP", clsClock() - t0, 1);
+
+        t0 = clsClock();
+        for (i = 0; i < N; i++)     /* Get the solution values */
+            for (t = 0; t < T; t++) {
+                solx[IT(i, t)] = x[IT(i, t)].getSol();
+                sols[IT(i, t)] = s[IT(i, t)].getSol();
+                soly[IT(i, t)] = y[IT(i, t)].getSol();
+                solz[IT(i, t)] = soly[IT(i, t)] + w[IT(i, t)].getSol();
+            }
+
+        nls = nvub = 0;             /* Search for violated constraints */
+        for (i = 0; i < N; i++) {
+            nls += sepLS(i, solx, sols, solz);
+            for (t = 0; t < T; t++)
+                nvub += sepVUB(i, t, solx, soly, solz);
+        }
+        fcuts.clear();
+        ccuts.clear();
+        for (t = 0; t < T; t++) {
+            sepFlowCover(t, solx, soly, solz, fcuts);
+            sepCover(t, soly, ccuts);
+        }
+        nfc = (int) fcuts.size();
+        addCuts(fcuts, "fc");
+        addCuts(ccuts, "cov");
+        npcut = nls + nvub + nfc + (int) ccuts.size();
+        clsRecord(&stats, "separation", clsClock() - t0, npcut);
+
+        cout << "Pass " << npass << ": objective value " << objval << ", cuts added: " << nls
+             << " (l,S), " << nvub << " VUB, " << nfc << " flow cover, " << ccuts.size()
+             << " cover (total " << ncut << ")" << endl;
+
+        if (npcut == 0 || objval - last < MINIMPROVE * fabs(objval)) break;
+        last = objval;
+        p.loadMat();                 /* Reload the problem */
+        p.loadBasis(basis);          /* Load the saved basis */
+        basis.reset();               /* No need to keep the basis any longer */
+    }
+    return objval;
+}
+
+/**************************************************************************/
+/*  Relax-and-fix heuristic: the setup variables of one window of         */
+/*  RFWINDOW periods at a time are integer, those of earlier windows are  */
+/*  fixed to their values and later ones are relaxed.                     */
+/*  Return value: cost of the plan found, XPRB_INFINITY if none           */
+/**************************************************************************/
+double relaxAndFix(int maxtime) {
+    int i, t, t1, nwin, win, N = DT.N, T = DT.T;
+    double t0, objval = XPRB_INFINITY;
+    XPRSprob xprob = p.getXPRSprob();
+
+    COLX.resize(N * T);                           /* Node cuts by callback */
+    COLY.resize(N * T);
+    COLW.resize(N * T);
+    for (i = 0; i < N * T; i++) {
+        COLX[i] = x[i].getColNum();
+        COLY[i] = y[i].getColNum();
+        COLW[i] = w[i].getColNum();
+    }
+    XPRSsetintcontrol(xprob, XPRS_MIPPRESOLVE, 0);
+    XPRSaddcboptnode(xprob, cbNodeCuts, NULL, 0);
+
+    nwin = (T + RFWINDOW - 1) / RFWINDOW;
+    for (i = 0; i < N * T; i++) {                 /* Relax all setups */
+        y[i].setType(XPRB_PL);
+        w[i].setType(XPRB_PL);
+        q[i].setType(XPRB_PL);
+    }
+
+    for (win = 0; win < nwin; win++) {
+        t0 = clsClock();
+        t1 = min(T, (win + 1) * RFWINDOW);
+        for (i = 0; i < N; i++)
+            for (t = win * RFWINDOW; t < t1; t++) {
+                y[IT(i, t)].setType(XPRB_BV);
+                w[IT(i, t)].setType(XPRB_BV);
+                q[IT(i, t)].setType(XPRB_BV);
+            }
+        if (maxtime > 0)
+            XPRSsetintcontrol(xprob, XPRS_MAXTIME, -max(1, maxtime / nwin));
+        p.mipOptimize("");
+        clsRecord(&stats, "relax-and-fix MIP", clsClock() - t0, 1);
+        clsRecord(&stats, "node cuts", 0, nodecuts.exchange(0));
+        if (p.getMIPStat() != XPRB_MIP_OPTIMAL && p.getMIPStat() != XPRB_MIP_SOLUTION) {
+            cout << "Relax-and-fix: no solution for window " << win + 1 << endl;
+            objval = XPRB_INFINITY;
+            break;
+        }
+        objval = p.getObjVal();
+        for (i = 0; i < N; i++)                   /* Fix the window */
+            for (t = win * RFWINDOW; t < t1; t++) {
+                y[IT(i, t)].fix(floor(y[IT(i, t)].getSol() + 0.5));
+                w[IT(i, t)].fix(floor(w[IT(i, t)].getSol() + 0.5));
+                q[IT(i, t)].fix(floor(q[IT(i, t)].getSol() + 0.5));
+            }
+    }
+
+    if (objval < XPRB_INFINITY) {                 /* All setups are fixed now */
+        INC.resize(3 * N * T);
+        for (i = 0; i < N * T; i++) {
+            INC[3 * i] = (int) floor(y[i].getSol() + 0.5);
+            INC[3 * i + 1] = (int) floor(w[i].getSol() + 0.5);
+            INC[3 * i + 2] = (int) floor(q[i].getSol() + 0.5);
+        }
+    }
+
+    for (i = 0; i < N * T; i++) {                 /* Restore the model */
+        y[i].setLB(0);
+        y[i].setUB(1);
+        w[i].setLB(0);
+        w[i].setUB(i % T > 0 && CARRY ? 1 : 0);
+        q[i].setLB(0);
+        q[i].setUB(1);
+    }
+    return objval;
+}
+
+/**************************************************************************/
+/*  Repair for ALNS: free the setups chosen by operator op, a share of    */
+/*  the items or periods, fix the others to the incumbent INC and solve   */
+/*  from the incumbent. A better solution replaces INC.                   */
+/**************************************************************************/
+double repairCls(int op, double share, double timebox, double best, int *optimal, mt19937 &rng) {
+    int i, k, t, t1, nfree, N = DT.N, T = DT.T, nt = N * T;
+    double z = HUGE_VAL;
+    vector<char> freed(nt, 0);
+    vector<int> perm;
+    XPRBsol start;
+
+    switch (op) {
+        case 0:                                   /* Window of periods */
+            nfree = max(1, (int) ceil(share * T));
+            t1 = rng() % max(1, T - nfree + 1);
+            for (i = 0; i < N; i++)
+                for (t = t1; t < min(T, t1 + nfree); t++) freed[IT(i, t)] = 1;
+            break;
+        case 1:                                   /* Items */
+            for (i = 0; i < N; i++) perm.push_back(i);
+            shuffle(perm.begin(), perm.end(), rng);
+            for (k = 0; k < max(1, (int) ceil(share * N)); k++)
+                for (t = 0; t < T; t++) freed[IT(perm[k], t)] = 1;
+            break;
+        default:                                  /* Random item-periods */
+            for (k = 0; k < nt; k++) perm.push_back(k);
+            shuffle(perm.begin(), perm.end(), rng);
+            for (k = 0; k < max(1, (int) ceil(share * nt)); k++) freed[perm[k]] = 1;
+    }
+
+    start = p.newSol();
+    for (k = 0; k < nt; k++) {
+        if (freed[k]) {
+            y[k].setLB(0);
+            y[k].setUB(1);
+            w[k].setLB(0);
+            w[k].setUB(k % T > 0 && CARRY ? 1 : 0);
+            q[k].setLB(0);
+            q[k].setUB(1);
+        } else {
+            y[k].fix(INC[3 * k]);
+            w[k].fix(INC[3 * k + 1]);
+            q[k].fix(INC[3 * k + 2]);
+        }
+        start.setVar(y[k], INC[3 * k]);
+        start.setVar(w[k], INC[3 * k + 1]);
+        start.setVar(q[k], INC[3 * k + 2]);
+    }
+    p.addMIPSol(start);
+    XPRSsetintcontrol(p.getXPRSprob(), XPRS_MAXTIME, -max(1, (int) timebox));
+    p.mipOptimize("");
+    *optimal = (p.getMIPStat() == XPRB_MIP_OPTIMAL);
+    if (p.getMIPStat() == XPRB_MIP_OPTIMAL || p.getMIPStat() == XPRB_MIP_SOLUTION) {
+        z = p.getObjVal();
+        if (z < best)
+            for (k = 0; k < nt; k++) {
+                INC[3 * k] = (int) floor(y[k].getSol() + 0.5);
+                INC[3 * k + 1] = (int) floor(w[k].getSol() + 0.5);
+                INC[3 * k + 2] = (int) floor(q[k].getSol() + 0.5);
+            }
+    }
+    return z;
+}
+
+/*  Improve the relax-and-fix solution INC of cost ub by ALNS */
+double alnsCls(double ub, int maxtime) {
+    const char *names[] = {"ALNS periods", "ALNS items", "ALNS random"};
+    ALNSState st;
+
+    alnsInit(&st, names, 3, ALNSFREE, 1);
+    ub = alnsRun(&st, ub, maxtime, ALNSTIMEBOX, [&](int op, double timebox, double best, int *optimal) {
+        return repairCls(op, st.free, timebox, best, optimal, st.rng);
+    }, &stats);
+    alnsPrintStats(&st);
+    return ub;
+}
+
+void solveCls(int maxtime) {
+    double lb, ub, t0;
+
+    t0 = clsClock();
+    lb = solveClsRoot();
+    clsRecord(&stats, "root total", clsClock() - t0, ncut);
+
+    t0 = clsClock();
+    ub = relaxAndFix(maxtime);
+    clsRecord(&stats, "heuristic total", clsClock() - t0, 1);
+    if (ALNSTIME > 0 && ub < XPRB_INFINITY) {
+        t0 = clsClock();
+        ub = alnsCls(ub, ALNSTIME);
+        clsRecord(&stats, "ALNS total", clsClock() - t0, 1);
+    }
+
+    cout << "Root bound " << lb << ", heuristic solution " << ub;
+    if (ub < XPRB_INFINITY) {
+        cout << ", root gap " << 100 * (ub - lb) / ub << "%";
+        if ((ub - lb) / ub > MAXROOTGAP)
+            cout << " (above target " << 100 * MAXROOTGAP << "%)";
+    }
+    cout << endl;
+    clsPrintStats(&stats);
+}
+
+/**************************************************************************/
+/*  Best plan of item i under the capacity duals pi[t] (NULL for none)    */
+/*  Return value: cost of the plan under the duals                        */
+/**************************************************************************/
+double pricePlan(int i, const double *pi, DWCol *col) {
+    int t, T = DT.T;
+    double z, stock = 0;
+    vector<double> setupc(T), prodc(T), holdc(T, DT.holdc[i]);
+
+    for (t = 0; t < T; t++) {
+        setupc[t] = DT.setupc[i] - (pi != NULL ? pi[t] * DT.stime[i] : 0);
+        prodc[t] = -(pi != NULL ? pi[t] * DT.ptime[i] : 0);
+    }
+    col->b = 0;
+    col->i = i;
+    col->row0 = 0;
+    col->prod.resize(T);
+    col->setup.resize(T);
+    z = wwSolve(T, &DT.dem[IT(i, 0)], &setupc[0], &prodc[0], &holdc[0], &col->prod[0], &col->setup[0]);
+
+    col->use.resize(T);
+    col->cost = 0;
+    for (t = 0; t < T; t++) {
+        stock += col->prod[t] - DT.dem[IT(i, t)];
+        col->use[t] = DT.ptime[i] * col->prod[t] + DT.stime[i] * col->setup[t];
+        col->cost += DT.setupc[i] * col->setup[t] + DT.holdc[i] * stock;
+    }
+    return z;
+}
+
+/*  Column generation over the plans of the items, one block (xbdw.h) */
+double solveClsDW(int maxtime) {
+    double lb;
+
+    dwInit(&DW, &pdw, DT.N, 1, DT.cap);
+    DW.grain = DWGRAIN;
+    DW.nthreads = NTHREADS;
+    DW.minimprove = MINIMPROVE;
+    lb = dwSolve(&DW, [](int b, int i, const double *pi, DWCol *col) { return pricePlan(i, pi, col); },
+                 maxtime, &stats);
+    if (pdw.getMIPStat() == XPRB_MIP_OPTIMAL || pdw.getMIPStat() == XPRB_MIP_SOLUTION)
+        cout << "DW solution " << pdw.getObjVal() << " from " << DW.cols.size() << " plans" << endl;
+    else
+        cout << "DW: no solution among the generated plans." << endl;
+    return lb;
+}
+
+void compareDW(int maxtime) {
+    double lbcut, lbdw, t0;
+
+    t0 = clsClock();
+    lbcut = solveClsRoot();
+    clsRecord(&stats, "root total", clsClock() - t0, ncut);
+
+    t0 = clsClock();
+    lbdw = solveClsDW(maxtime);
+    clsRecord(&stats, "DW total", clsClock() - t0, (long) DW.cols.size());
+
+    cout << "Root bound: cut loop " << lbcut << ", column generation " << lbdw << endl;
+    clsPrintStats(&stats);
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, dw = 0, maxtime = 0, features = 0;
+    double v[CLSNFEATURES];
+
+    clsGenerate(&DT, 100, 50, 0.8, 1);     /* Default: 100 items, 50 periods */
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-nocarry"))
+            CARRY = 0;
+        else if (!strcmp(argv[i], "-dw"))
+            dw = 1;
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-alns") && i + 1 < argc)
+            ALNSTIME = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-features"))
+            features = 1;
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    if (features) {
+        clsFeatures(&DT, v);
+        cout << "Features:";
+        for (i = 0; i < CLSNFEATURES; i++) cout << " " << v[i];
+        cout << endl;
+        return 0;
+    }
+    if (NTHREADS > 0) {            /* Optimizer threads as well */
+        XPRSsetintcontrol(p.getXPRSprob(), XPRS_THREADS, NTHREADS);
+        XPRSsetintcontrol(pdw.getXPRSprob(), XPRS_THREADS, NTHREADS);
+    }
+
+    if (dw) CARRY = 0;             /* Plans of single items: no carryover */
+    modCls();                      /* Model the problem */
+    if (dw)
+        compareDW(maxtime);
+    else
+        solveCls(maxtime);         /* Solve the problem */
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbcls.h
+  ````````````
+  Data of the multi-item capacitated lot sizing
+  problem: N items, T periods, demand per item and
+  period, setup and holding cost, unit production time
+  and setup time per item, capacity per period.
+
+  Data file format:
+    N T
+    cap[0] ... cap[T-1]
+    one line per item:
+      setupc holdc ptime stime dem[0] ... dem[T-1]
+
+  Also a small instrumentation record (phase timings
+  and counters) shared by the lot sizing solvers.
+********************************************************/
+
+#ifndef XBCLS_H
+#define XBCLS_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+typedef struct {
+    int N, T;                     /* Number of items and periods */
+    std::vector<double> dem;      /* dem[i*T+t]: demand of item i in t */
+    std::vector<double> setupc;   /* Setup cost per item */
+    std::vector<double> holdc;    /* Unit holding cost per item and period */
+    std::vector<double> ptime;    /* Capacity used per unit of item i */
+    std::vector<double> stime;    /* Capacity used by a setup of item i */
+    std::vector<double> cap;      /* Capacity per period */
+} CLSData;
+
+/* Demand of item i in periods t1..t2 */
+static inline double clsDem(const CLSData *dt, int i, int t1, int t2) {
+    double d = 0;
+
+    for (; t1 <= t2; t1++) d += dt->dem[i * dt->T + t1];
+    return d;
+}
+
+static inline int clsRead(CLSData *dt, const char *fname) {
+    int i, t;
+    std::ifstream in(fname);
+
+    if (!(in >> dt->N >> dt->T) || dt->N < 1 || dt->T < 1) {
+        std::cout << "Invalid data file " << fname << std::endl;
+        return 0;
+    }
+    dt->cap.resize(dt->T);
+    for (t = 0; t < dt->T; t++) in >> dt->cap[t];
+    dt->dem.resize(dt->N * dt->T);
+    dt->setupc.resize(dt->N);
+    dt->holdc.resize(dt->N);
+    dt->ptime.resize(dt->N);
+    dt->stime.resize(dt->N);
+    for (i = 0; i < dt->N; i++) {
+        in >> dt->setupc[i] >> dt->holdc[i] >> dt->ptime[i] >> dt->stime[i];
+        for (t = 0; t < dt->T; t++) in >> dt->dem[i * dt->T + t];
+    }
+    if (!in) {
+        std::cout << "Incomplete data file " << fname << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+/**************************************************************************/
+/* Random instance with about 20% zero demands. The capacity targets the  */
+/* utilization 'util' but is never less than what producing every        */
+/* period's demand in that period (lot-for-lot) needs, so that the        */
+/* instance is feasible without initial stock.                            */
+/**************************************************************************/
+static inline void clsGenerate(CLSData *dt, int N, int T, double util, unsigned seed) {
+    int i, t;
+    double need, total = 0;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+
+    dt->N = N;
+    dt->T = T;
+    dt->dem.resize(N * T);
+    dt->setupc.resize(N);
+    dt->holdc.resize(N);
+    dt->ptime.resize(N);
+    dt->stime.resize(N);
+    dt->cap.resize(T);
+    for (i = 0; i < N; i++) {
+        dt->setupc[i] = floor(50 + 450 * U(rng));
+        dt->holdc[i] = floor(1 + 4 * U(rng));
+        dt->ptime[i] = floor(10 + 10 * U(rng)) / 10;
+        dt->stime[i] = floor(5 + 15 * U(rng));
+        for (t = 0; t < T; t++) {
+            dt->dem[i * T + t] = (U(rng) < 0.2 ? 0 : floor(20 + 80 * U(rng)));
+            total += dt->ptime[i] * dt->dem[i * T + t];
+        }
+    }
+    for (t = 0; t < T; t++) {
+        need = 0;
+        for (i = 0; i < N; i++)
+            if (dt->dem[i * T + t] > 0)
+                need += dt->ptime[i] * dt->dem[i * T + t] + dt->stime[i];
+        dt->cap[t] = ceil(std::max(need, total / T / util));
+    }
+}
+
+/**************************************************************************/
+/* Instance features for solve-time prediction (see xbbatch.cxx): sizes,  */
+/* utilization of the capacity by production and setups, and the share    */
+/* of the setups in it.                                                   */
+/**************************************************************************/
+#define CLSNFEATURES 4
+
+static inline void clsFeatures(const CLSData *dt, double *v) {
+    int i, t;
+    double prod = 0, setup = 0, cap = 0;
+
+    for (t = 0; t < dt->T; t++) cap += dt->cap[t];
+    for (i = 0; i < dt->N; i++)
+        for (t = 0; t < dt->T; t++)
+            if (dt->dem[i * dt->T + t] > 0) {
+                prod += dt->ptime[i] * dt->dem[i * dt->T + t];
+                setup += dt->stime[i];
+            }
+    v[0] = log(1.0 + dt->N);
+    v[1] = log(1.0 + dt->T);
+    v[2] = (prod + setup) / cap;
+    v[3] = setup / std::max(1e-9, prod + setup);
+}
+
+/**************************************************************************/
+/* Instrumentation: time and a counter per named phase                    */
+/**************************************************************************/
+typedef struct {
+    std::vector<const char *> name;
+    std::vector<double> sec;
+    std::vector<long> count;
+} CLSStats;
+
+static inline double clsClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline void clsRecord(CLSStats *st, const char *name, double sec, long count) {
+    size_t k;
+
+    for (k = 0; k < st->name.size() && st->name[k] != name; k++);
+    if (k == st->name.size()) {
+        st->name.push_back(name);
+        st->sec.push_back(0);
+        st->count.push_back(0);
+    }
+    st->sec[k] += sec;
+    st->count[k] += count;
+}
+
+static inline void clsPrintStats(const CLSStats *st) {
+    size_t k;
+
+    std::cout << "Phase statistics:" << std::endl;
+    for (k = 0; k < st->name.size(); k++)
+        std::cout << "   " << st->name[k] << ": " << st->sec[k] << " sec, " << st->count[k] << std::endl;
+}
+
+#endif
@@ -4,55 +4,242 @@
 
   file xbcutstk.cxx
   `````````````````
-  Cutting stock problem, solved by column (= cutting 
+  Cutting stock problem, solved by column (= cutting
   pattern) generation heuristic looping over the
   root node.
 
+  Alternative solution engines (column generation with
+  DP pricing, arc-flow MIP, MIP over all maximal
+  patterns) are chosen per instance by a selector
+  working on features of WIDTH/DEMAND/MAXWIDTH.
+
+  With -race two or three engines are run concurrently
+  as tasks of one task group (see xbthreads.h), sharing
+  incumbents and bounds; the first proven-optimal
+  answer cancels the group, which stops the running
+  racers and skips those not started yet.
+
+  solveCutStockAnytime() solves against a wall-clock
+  limit, reporting each improved solution or bound
+  through a callback; when time gets short, exact
+  pricing is replaced by a greedy heuristic.
+
+  With -det racers do not exchange results while running
+  and use fixed optimizer thread settings; their results
+  are combined in engine order once all have finished, so
+  the outcome does not depend on thread timing (time
+  limits excepted). The time spent against the default
+  mode is reported. Without -threads every racer asks the
+  core budget (see xbthreads.h) for an even share of the
+  cores.
+
+  The master problems of all engines use the optimizer
+  controls found by the tuner (xbtune.cxx) for this
+  family, read from xbcutstk.prm or the file given with
+  -params (see xbparams.h).
+
+  -features prints the selector's feature vector of the
+  instance, which the batch scheduler (xbbatch.cxx) uses
+  to predict the solution time, and stops.
+
+  With -cache, solutions of single-engine runs are kept
+  in a solution cache file (see xbcache.h) under the
+  engine, the optimizer controls and the instance with
+  its widths sorted; a repeated instance, in any order
+  of the widths, is answered from the cache after
+  checking the plan against it, and the run exits with
+  status XBCACHEHIT.
+
+  The master LP of column generation goes through an
+  LP backend (CSLpBackend): by default the optimizer,
+  reloading the matrix and the saved basis after each
+  new column. -lp embedded selects the embedded dual
+  simplex of xblp.h, which keeps its basis and puts a
+  new column at its upper bound so that the next solve
+  starts dual feasible; -lp auto selects it for masters
+  of up to LPSMALLROWS rows only. If the embedded solve
+  fails the optimizer takes over.
+
+  Usage: xbcutstk [datafile] [-engine name | -race]
+                  [-maxtime ms] [-det] [-threads n]
+                  [-model file] [-bench file]
+                  [-params file] [-features]
+                  [-cache file]
+                  [-lp optimizer|embedded|auto]
+         xbcutstk -train benchfile modelfile
+
   (c) 2008 Fair Isaac Corporation
       author: S.Heipcke, 2001, rev. Mar. 2014
 ********************************************************/
 
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbparams.h"
+#include "xbthreads.h"
+#include "xbcache.h"
+#include "xblp.h"
+#include "xbanytime.h"
 
 using namespace std;
 using namespace ::dashoptimization;
 
-#define NWIDTHS 5     //number of demanded width
-#define MAXWIDTH 94   //the max width of the raw material
+#define MAXNWIDTHS 100   //max. number of demanded widths
 
 #define EPS 1e-6
 #define MAXCOL 10   //number of so-called raw material
 
+#define ENG_COLGEN  0   /* Column generation, MIP knapsack pricing */
+#define ENG_DPPRICE 1   /* Column generation, DP knapsack pricing */
+#define ENG_ARCFLOW 2   /* Arc-flow MIP */
+#define ENG_ENUM    3   /* MIP over all maximal patterns */
+#define NENGINES    4
+
+#define NFEATURES 8          /* Length of the selector feature vector */
+#define ENUMMAXPAT 2000      /* Max. number of patterns for ENG_ENUM */
+#define ARCMAXARCS 20000     /* Max. arc-flow graph size for ENG_ARCFLOW */
+#define DPMAXCELLS 20000000  /* Max. DP table size for ENG_DPPRICE */
+#define SELECTLOG "xbcutstk_select.log"  /* Log of selection decisions */
+#define LPSMALLROWS 50       /* Max. rows of a master for the embedded LP */
+#define LPMAXITER 10000      /* Iteration limit of an embedded LP solve */
+
 /****DATA****/
-double WIDTH[] = {17, 21, 22.5, 24, 29.5};  /* Possible widths */
-int DEMAND[] = {150, 96, 48, 108, 227};     /* Demand per width */
-int PATTERNS[NWIDTHS][NWIDTHS];              /* (Basic) cutting patterns, also known as the initial cutting patterns*/
+int NWIDTHS = 5;                             /* Number of demanded widths */
+double MAXWIDTH = 94;                        /* Width of the raw material */
+double WIDTH[MAXNWIDTHS] = {17, 21, 22.5, 24, 29.5};  /* Possible widths */
+int DEMAND[MAXNWIDTHS] = {150, 96, 48, 108, 227};     /* Demand per width */
+int PATTERNS[MAXNWIDTHS][MAXNWIDTHS];        /* (Basic) cutting patterns, also known as the initial cutting patterns*/
 
-XPRBvar pat[NWIDTHS + MAXCOL];               /* Rolls per pattern. Note MAXCOL here is no explicit meaning ,but to save space
+XPRBvar pat[MAXNWIDTHS + MAXCOL];            /* Rolls per pattern. Note MAXCOL here is no explicit meaning ,but to save space
  * Can prove new patterns is less than MAXCOL? */
 //XPRBvar pat[100];
-XPRBctr dem[NWIDTHS];                      /* Demand constraints */
+XPRBctr dem[MAXNWIDTHS];                   /* Demand constraints */
 XPRBctr cobj;                              /* Objective function */
 
 XPRBprob p("CutStock");                    /* Initialize a new problem in BCL */
 
+const char *ENGNAME[NENGINES] = {"colgen", "dppricing", "arcflow", "enum"};
+
+typedef struct {
+    int nwidths;             /* Number of demanded widths */
+    double totdemand;        /* Total number of pieces demanded */
+    double minratio;         /* Smallest width relative to MAXWIDTH */
+    double maxratio;         /* Largest width relative to MAXWIDTH */
+    double itemsperroll;     /* Max. number of pieces cut from one roll */
+    int scale;               /* Factor making all widths integral, 0 if none */
+    double arcs;             /* Size of the arc-flow graph */
+    double npatterns;        /* Number of maximal patterns (capped) */
+} CSFeatures;
+
+typedef void (*CSCallback)(double obj, double bound, void *data);
+
+typedef struct {
+    atomic<double> incumbent;  /* Best number of rolls found by any racer */
+    atomic<double> bound;      /* Best lower bound proven by any racer */
+    atomic<int> winner;        /* Racer closing the gap, -1 while racing */
+    int start;                 /* XPRB::getTime() at the start */
+    int deadline;              /* XPRB::getTime() limit, 0 for none */
+    int threads;               /* Optimizer threads wanted per racer */
+    XBTaskGroup group;         /* Racers; cancelled once the race is decided */
+    CSCallback cb;             /* Called on improved solution or bound */
+    void *cbdata;
+    mutex cblock;              /* Serializes the calls to 'cb' */
+} CSRace;
+
+typedef struct {
+    int engine;                /* Racer owning an optimizer problem */
+    int exact;                 /* Whether its MIP bound is a valid bound */
+    atomic<double> incumbent;  /* Own results in deterministic mode */
+    atomic<double> bound;
+    int finish;                /* XPRB::getTime() when it finished */
+    int threads;               /* Optimizer threads granted */
+} CSRacer;
+
+typedef struct {
+    const char *name;
+    void (*init)();            /* Master LP of modCutStock() */
+    int (*solve)(int npatt, double *objval, double *solpat, double *dualdem);  /* 0 if failed */
+    void (*addCol)(int npatt, const int *x);  /* Column pat[npatt] was added */
+    void (*done)();
+} CSLpBackend;
+
+CSRace *race = NULL;                       /* Shared state while racing */
+CSRacer RACER[NENGINES];
+int DETERMINISTIC = 0;                     /* Reproducible racing */
+int NTHREADS = 0;                          /* Optimizer threads, 0 for default */
+XBParams PARAMS;                           /* Tuned optimizer controls */
+
+vector<vector<int> > PLANPAT;              /* Cutting plan of the last solve */
+vector<int> PLANROLLS;                     /* ... and the rolls per pattern */
+XBCache CACHE = {-1, NULL, NULL};          /* Solution cache */
+int LPCHOICE = 0;                          /* Master LP: 0 optimizer, 1 embedded, -1 by size */
+XPRBbasis LPBASIS;                         /* Optimizer basis between passes */
+XBLp LPMASTER;                             /* Embedded master LP */
+
+double SELWEIGHT[NENGINES][NFEATURES];     /* Trained selector: log-time model */
+int SELTRAINED[NENGINES];                  /* Whether an engine has a model */
+
 double knapsack(int N, double *c, double *a, double R, int *d, int *xbest);
+double knapsackDP(int N, double *c, double *a, double R, int *d, int *xbest);
+double knapsackGreedy(int N, double *c, double *a, double R, int *d, int *xbest);
+double greedyRolls();
+double (*pricer)(int, double *, double *, double, int *, int *) = knapsack;
+void raceAttach(XPRBprob &prob, int engine, int exact);
+void raceMIPDone(XPRBprob &prob, int engine, int exact);
+void raceBound(double bd, int engine);
+int raceStopped();
+
+/***********************************************************************/
+
+/* Read an instance: MAXWIDTH and NWIDTHS, followed by one line
+   'width demand' per demanded width */
+int readData(const char *fname) {
+    int j;
+    ifstream in(fname);
+
+    if (!(in >> MAXWIDTH >> NWIDTHS) || NWIDTHS < 1 || NWIDTHS > MAXNWIDTHS) {
+        cout << "Invalid data file " << fname << endl;
+        return 0;
+    }
+    for (j = 0; j < NWIDTHS; j++)
+        if (!(in >> WIDTH[j] >> DEMAND[j]) || WIDTH[j] > MAXWIDTH || WIDTH[j] <= 0) {
+            cout << "Invalid width/demand " << j + 1 << " in " << fname << endl;
+            return 0;
+        }
+    return 1;
+}
+
+/* Add 'rolls' rolls of the pattern cnt to the plan (single engine only) */
+void planAdd(int rolls, const int *cnt) {
+    if (race != NULL || rolls <= 0) return;
+    PLANPAT.push_back(vector<int>(cnt, cnt + NWIDTHS));
+    PLANROLLS.push_back(rolls);
+}
 
 /***********************************************************************/
 
 void modCutStock() {
     int i, j;
+    char name[32];
     XPRBexpr le;
 
     for (j = 0; j < NWIDTHS; j++)
         PATTERNS[j][j] = (int) floor(MAXWIDTH / WIDTH[j]);
 
     /****VARIABLES****/
-    for (j = 0; j < NWIDTHS; j++)
-        pat[j] = p.newVar(XPRBnewname("pat_%d", j + 1), XPRB_UI, 0,
-                          (int) ceil((double) DEMAND[j] / PATTERNS[j][j]));
+    for (j = 0; j < NWIDTHS; j++) {
+        snprintf(name, sizeof(name), "pat_%d", j + 1);  /* Not XPRBnewname: racers run concurrently */
+        pat[j] = p.newVar(name, XPRB_UI, 0, (int) ceil((double) DEMAND[j] / PATTERNS[j][j]));
+    }
 
     /****OBJECTIVE****/
     for (j = 0; j < NWIDTHS; j++)
@@ -70,46 +257,148 @@ void modCutStock() {
     }
 }
 
+/**************************************************************************/
+/*  Master LP backends                                                    */
+/**************************************************************************/
+void lpXpressInit() {}
+
+int lpXpressSolve(int npatt, double *objval, double *solpat, double *dualdem) {
+    int i, j;
+
+    p.lpOptimize("");              /* Solve the LP */
+    if (p.getLPStat() != XPRB_LP_OPTIMAL) return 0;   /* E.g. interrupted */
+    LPBASIS = p.saveBasis();       /* Save the current basis */
+    *objval = p.getObjVal();       /* Get the objective value */
+    for (j = 0; j < npatt; j++)
+        solpat[j] = pat[j].getSol();
+    for (i = 0; i < NWIDTHS; i++)
+        dualdem[i] = dem[i].getDual();
+    return 1;
+}
+
+void lpXpressAddCol(int npatt, const int *x) {
+    p.loadMat();                   /* Reload the problem */
+    p.loadBasis(LPBASIS);          /* Load the saved basis */
+    LPBASIS.reset();               /* No need to keep the basis any longer */
+}
+
+void lpXpressDone() {
+    LPBASIS.reset();
+}
+
+void lpEmbedInit() {
+    int i, j;
+    double rlo[MAXNWIDTHS], rhi[MAXNWIDTHS], col[MAXNWIDTHS];
+
+    for (i = 0; i < NWIDTHS; i++) {
+        rlo[i] = DEMAND[i];
+        rhi[i] = XBLP_INF;
+    }
+    xbLpInit(&LPMASTER, NWIDTHS, rlo, rhi);
+    for (j = 0; j < NWIDTHS; j++) {
+        for (i = 0; i < NWIDTHS; i++) col[i] = PATTERNS[i][j];
+        xbLpAddCol(&LPMASTER, 1, col, 0, pat[j].getUB());
+    }
+}
+
+int lpEmbedSolve(int npatt, double *objval, double *solpat, double *dualdem) {
+    int i, j;
+
+    if (xbLpSolve(&LPMASTER, LPMAXITER) != XBLP_OPTIMAL) return 0;
+    *objval = LPMASTER.obj;
+    for (j = 0; j < npatt; j++)
+        solpat[j] = xbLpSol(&LPMASTER, j);
+    for (i = 0; i < NWIDTHS; i++)
+        dualdem[i] = xbLpDual(&LPMASTER, i);
+    return 1;
+}
+
+/* The new column enters nonbasic; the optimizer does not see it until the MIP */
+void lpEmbedAddCol(int npatt, const int *x) {
+    int i;
+    double col[MAXNWIDTHS];
+
+    for (i = 0; i < NWIDTHS; i++) col[i] = x[i];
+    xbLpAddCol(&LPMASTER, 1, col, 0, pat[npatt].getUB());
+}
+
+void lpEmbedDone() {
+    cout << "Embedded master LP: " << LPMASTER.itertot << " dual simplex iterations" << endl;
+}
+
+CSLpBackend LPOPTIMIZER = {"optimizer", lpXpressInit, lpXpressSolve, lpXpressAddCol, lpXpressDone};
+CSLpBackend LPEMBEDDED = {"embedded", lpEmbedInit, lpEmbedSolve, lpEmbedAddCol, lpEmbedDone};
+
+/* Whether the master of this instance goes to the embedded LP */
+int lpEmbedded() {
+    return LPCHOICE > 0 || (LPCHOICE < 0 && NWIDTHS <= LPSMALLROWS);
+}
+
 /**************************************************************************/
 /*  Column generation loop at the top node:                               */
-/*    solve the LP and save the basis                                     */
+/*    solve the LP (backend keeps the basis)                              */
 /*    get the solution values                                             */
 /*    generate new column(s) (=cutting pattern)                           */
-/*    load the modified problem and load the saved basis                  */
+/*    add the column to the model and the backend (warm start)            */
 /**************************************************************************/
-void solveCutStock() {
+double solveCutStock() {
     double objval;                  /* Objective value */
     int i, j;
     int starttime;
     int npatt, npass;               /* Counters for columns and passes */
-    double solpat[NWIDTHS + MAXCOL];  /* Solution values for variables pat */
-    double dualdem[NWIDTHS];        /* Dual values of demand constraints */
-    XPRBbasis basis;
+    double solpat[MAXNWIDTHS + MAXCOL];  /* Solution values for variables pat */
+    double dualdem[MAXNWIDTHS];     /* Dual values of demand constraints */
+    CSLpBackend *lp;                /* Master LP backend */
     double dw, z;
-    int x[NWIDTHS];
+    int x[MAXNWIDTHS], engine, left, cnt[MAXNWIDTHS], solved;
+    int newpat[MAXCOL][MAXNWIDTHS];  /* Generated patterns */
+    char name[32];
 
     starttime = XPRB::getTime();
     npatt = NWIDTHS;   //initially set to the number of widths
+    engine = (pricer == knapsackDP ? ENG_DPPRICE : ENG_COLGEN);
+    xbApplyParams(p.getXPRSprob(), &PARAMS);
+    if (race != NULL) raceAttach(p, engine, 0);
+    lp = (lpEmbedded() ? &LPEMBEDDED : &LPOPTIMIZER);
+    lp->init();
 
     for (npass = 0; npass < MAXCOL; npass++) {
-        p.lpOptimize("");              /* Solve the LP */
-        basis = p.saveBasis();         /* Save the current basis */
-        objval = p.getObjVal();        /* Get the objective value */
-
-        /* Get the solution values: */
-        for (j = 0; j < npatt; j++)
-            solpat[j] = pat[j].getSol();
-        for (i = 0; i < NWIDTHS; i++)
-            dualdem[i] = dem[i].getDual();
+        if (raceStopped()) break;      /* Another racer has finished */
+        if (race != NULL && race->deadline > 0) {
+            left = race->deadline - XPRB::getTime();
+            if (left < (race->deadline - race->start) / 4) {
+                cout << "Short of time, stopping column generation." << endl;
+                break;                 /* Keep the remaining time for the MIP */
+            }
+            if (left < (race->deadline - race->start) / 2 && pricer != knapsackGreedy) {
+                cout << "Short of time, switching to heuristic pricing." << endl;
+                pricer = knapsackGreedy;
+            }
+        }
+        /* Solve the LP, get the objective and solution values: */
+        solved = lp->solve(npatt, &objval, solpat, dualdem);
+        if (!solved && lp == &LPEMBEDDED) {
+            cout << "Embedded master LP failed, using the optimizer." << endl;
+            lp->done();
+            lp = &LPOPTIMIZER;
+            solved = lp->solve(npatt, &objval, solpat, dualdem);
+        }
+        if (raceStopped()) break;      /* The duals of an interrupted LP are not valid */
+        if (!solved) {
+            cout << "Master LP not solved, stopping column generation." << endl;
+            break;
+        }
 
         /* Solve integer knapsack problem  z = min{cx : ax<=r, x in Z^n}
            with r=MAXWIDTH, n=NWIDTHS */
-        z = knapsack(NWIDTHS, dualdem, WIDTH, (double) MAXWIDTH, DEMAND, x);
+        z = pricer(NWIDTHS, dualdem, WIDTH, MAXWIDTH, DEMAND, x);
         cout << "(" << (XPRB::getTime() - starttime) / 1000.0 << " sec) Pass " << npass + 1 << ": ";
 
+        /* With exact pricing objval/max(1,z) is a lower bound (Farley) */
+        if (race != NULL && pricer != knapsackGreedy) raceBound(objval / max(z, 1.0), engine);
+
         if (z < 1 + EPS) {
             cout << "no profitable column found." << endl << endl;
-            basis.reset();                  /* No need to keep the basis any longer */
             break;
         } else {
             /* Print the new pattern: */
@@ -123,7 +412,9 @@ void solveCutStock() {
             cout << "Total width: " << dw << endl;
 
             /* Create a new variable for this pattern: */
-            pat[npatt] = p.newVar(XPRBnewname("pat_%d", npatt + 1), XPRB_UI);
+            snprintf(name, sizeof(name), "pat_%d", npatt + 1);
+            pat[npatt] = p.newVar(name, XPRB_UI);
+            memcpy(newpat[npatt - NWIDTHS], x, NWIDTHS * sizeof(int));
 
             cobj += pat[npatt];             /* Add new var. to the objective */
             dw = 0;
@@ -135,15 +426,16 @@ void solveCutStock() {
                 }
             pat[npatt].setUB(dw);           /* Change the upper bound on the new var.*/
 
-            npatt++;
+            lp->addCol(npatt, x);
 
-            p.loadMat();                    /* Reload the problem */
-            p.loadBasis(basis);             /* Load the saved basis */
-            basis.reset();                  /* No need to keep the basis any longer */
+            npatt++;
         }
     }
+    lp->done();
 
+    if (raceStopped()) return -1;
     p.mipOptimize("");                /* Solve the MIP */
+    if (race != NULL) raceMIPDone(p, engine, 0);
 
     cout << "(" << (XPRB::getTime() - starttime) / 1000.0 << " sec) Optimal solution: " << p.getObjVal() << " rolls, "
          << npatt << " patterns" << endl << "   ";
@@ -151,6 +443,682 @@ void solveCutStock() {
     for (i = 0; i < npatt; i++)
         cout << pat[i].getSol() << ", ";
     cout << endl;
+
+    for (j = 0; j < npatt; j++) {
+        for (i = 0; i < NWIDTHS; i++)
+            cnt[i] = (j < NWIDTHS ? PATTERNS[i][j] : newpat[j - NWIDTHS][i]);
+        planAdd((int) floor(pat[j].getSol() + 0.5), cnt);
+    }
+
+    return p.getObjVal();
+}
+
+/**************************************************************************/
+/* Smallest factor (1, 2, 4, 5, 10, ..., 1000) that turns MAXWIDTH and    */
+/* all widths into integers; 0 if there is none                           */
+/**************************************************************************/
+int getScale() {
+    static const int factors[] = {1, 2, 4, 5, 8, 10, 20, 25, 50, 100, 1000};
+    int f, j;
+    double v;
+
+    for (f = 0; f < (int) (sizeof(factors) / sizeof(factors[0])); f++) {
+        v = MAXWIDTH * factors[f];
+        if (fabs(v - floor(v + 0.5)) > EPS) continue;
+        for (j = 0; j < NWIDTHS; j++) {
+            v = WIDTH[j] * factors[f];
+            if (fabs(v - floor(v + 0.5)) > EPS) break;
+        }
+        if (j == NWIDTHS) return factors[f];
+    }
+    return 0;
+}
+
+/**************************************************************************/
+/* Arc-flow graph: nodes 0..W are the (scaled) positions on a roll, an    */
+/* item arc (u, u+w[j]) places a piece of width j at position u. Items    */
+/* are placed in order of decreasing width, so an arc for width j only    */
+/* leaves nodes reachable with widths placed before j. Loss arcs lead     */
+/* from every reached position to the end of the roll W.                 */
+/* Return value: W; item[a] is -1 for loss arcs                           */
+/**************************************************************************/
+int buildArcFlow(int scale, vector<int> &tail, vector<int> &head, vector<int> &item) {
+    int j, k, u, W;
+    int w[MAXNWIDTHS], order[MAXNWIDTHS];
+    vector<char> reach;
+
+    W = (int) floor(MAXWIDTH * scale + EPS);
+    for (j = 0; j < NWIDTHS; j++) {
+        w[j] = (int) floor(WIDTH[j] * scale + 0.5);
+        order[j] = j;
+    }
+    for (j = 1; j < NWIDTHS; j++)                 /* Sort by decreasing width */
+        for (k = j; k > 0 && w[order[k]] > w[order[k - 1]]; k--)
+            swap(order[k], order[k - 1]);
+
+    tail.clear();
+    head.clear();
+    item.clear();
+    reach.assign(W + 1, 0);
+    reach[0] = 1;
+    for (k = 0; k < NWIDTHS; k++) {
+        j = order[k];
+        for (u = 0; u + w[j] <= W; u++)           /* Nodes reached by width j */
+            if (reach[u]) {                       /* itself come later: repeats */
+                tail.push_back(u);
+                head.push_back(u + w[j]);
+                item.push_back(j);
+                reach[u + w[j]] = 1;
+            }
+    }
+    for (u = 1; u < W; u++)
+        if (reach[u]) {
+            tail.push_back(u);
+            head.push_back(W);
+            item.push_back(-1);
+        }
+    return W;
+}
+
+/**************************************************************************/
+/* Enumerate the maximal cutting patterns: no further piece of any width  */
+/* with remaining demand fits into the roll. Enumeration stops once more  */
+/* than 'maxpat' patterns have been found.                                */
+/* Return value: number of patterns found (at most maxpat+1)              */
+/**************************************************************************/
+static void enumRec(int j, double rest, int *x, int *lim, int maxpat, vector<vector<int> > &pats) {
+    int k, i;
+
+    if ((int) pats.size() > maxpat) return;
+    if (j == NWIDTHS) {
+        for (i = 0; i < NWIDTHS; i++)            /* Check maximality */
+            if (x[i] < lim[i] && WIDTH[i] <= rest + EPS) return;
+        pats.push_back(vector<int>(x, x + NWIDTHS));
+        return;
+    }
+    for (k = min(lim[j], (int) floor(rest / WIDTH[j] + EPS)); k >= 0; k--) {
+        x[j] = k;
+        enumRec(j + 1, rest - k * WIDTH[j], x, lim, maxpat, pats);
+    }
+    x[j] = 0;
+}
+
+int enumPatterns(int maxpat, vector<vector<int> > &pats) {
+    int j;
+    int x[MAXNWIDTHS], lim[MAXNWIDTHS];
+
+    for (j = 0; j < NWIDTHS; j++) {
+        x[j] = 0;
+        lim[j] = min(DEMAND[j], (int) floor(MAXWIDTH / WIDTH[j] + EPS));
+    }
+    pats.clear();
+    enumRec(0, MAXWIDTH, x, lim, maxpat, pats);
+    return (int) pats.size();
+}
+
+/**************************************************************************/
+/*  Arc-flow model: integer flow from 0 to W through the arc-flow graph,  */
+/*  the number of item arcs of width j used satisfies its demand. The     */
+/*  flow is decomposed into patterns for printing.                        */
+/**************************************************************************/
+double solveArcFlow() {
+    int a, j, u, W, scale, starttime, narcs, k;
+    double objval;
+    char name[32];
+    vector<int> tail, head, item, flow, cnt;
+    vector<XPRBvar> x;
+    vector<XPRBexpr> bal;
+    XPRBexpr le;
+    XPRBprob pa("ArcFlow");
+
+    starttime = XPRB::getTime();
+    scale = getScale();
+    if (scale == 0) {
+        cout << "Arc-flow: widths cannot be scaled to integers." << endl;
+        return -1;
+    }
+    W = buildArcFlow(scale, tail, head, item);
+    narcs = (int) tail.size();
+
+    /****VARIABLES****/
+    x.resize(narcs);
+    for (a = 0; a < narcs; a++) {
+        snprintf(name, sizeof(name), "f_%d_%d", tail[a], head[a]);
+        x[a] = pa.newVar(name, XPRB_UI, 0, item[a] >= 0 ? DEMAND[item[a]] : XPRB_INFINITY);
+    }
+
+    /****OBJECTIVE****/
+    for (a = 0; a < narcs; a++)
+        if (tail[a] == 0) le += x[a];     /* Minimize the number of rolls */
+    pa.setObj(pa.newCtr("OBJ", le));
+
+    /****CONSTRAINTS****/
+    bal.resize(W + 1);                    /* Flow conservation */
+    for (a = 0; a < narcs; a++) {
+        bal[tail[a]] -= x[a];
+        bal[head[a]] += x[a];
+    }
+    for (u = 1; u < W; u++)
+        pa.newCtr("Flow", bal[u] == 0);
+
+    for (j = 0; j < NWIDTHS; j++) {       /* Satisfy the demand per width */
+        le = 0;
+        for (a = 0; a < narcs; a++)
+            if (item[a] == j) le += x[a];
+        pa.newCtr("Demand", le >= DEMAND[j]);
+    }
+
+    xbApplyParams(pa.getXPRSprob(), &PARAMS);
+    if (race != NULL) raceAttach(pa, ENG_ARCFLOW, 1);
+    pa.mipOptimize("");
+    if (race != NULL) raceMIPDone(pa, ENG_ARCFLOW, 1);
+    if (pa.getMIPStat() != XPRB_MIP_OPTIMAL && pa.getMIPStat() != XPRB_MIP_SOLUTION) return -1;
+    objval = pa.getObjVal();
+    cout << "(" << (XPRB::getTime() - starttime) / 1000.0 << " sec) Arc-flow: " << objval
+         << " rolls, graph with " << W + 1 << " nodes and " << narcs << " arcs" << endl;
+
+    /* Decompose the flow into patterns: */
+    flow.resize(narcs);
+    for (a = 0; a < narcs; a++)
+        flow[a] = (int) floor(x[a].getSol() + 0.5);
+    cnt.resize(NWIDTHS);
+    for (;;) {
+        for (a = 0; a < narcs && (tail[a] != 0 || flow[a] == 0); a++);
+        if (a == narcs) break;
+        k = flow[a];
+        fill(cnt.begin(), cnt.end(), 0);
+        vector<int> path;
+        for (u = 0; u < W;) {             /* Follow a path with positive flow */
+            for (a = 0; a < narcs && (tail[a] != u || flow[a] == 0); a++);
+            if (a == narcs) break;
+            path.push_back(a);
+            k = min(k, flow[a]);
+            u = head[a];
+        }
+        for (a = 0; a < (int) path.size(); a++) {
+            flow[path[a]] -= k;
+            if (item[path[a]] >= 0) cnt[item[path[a]]]++;
+        }
+        cout << "   " << k << " x  ";
+        for (j = 0; j < NWIDTHS; j++)
+            if (cnt[j] > 0) cout << WIDTH[j] << ":" << cnt[j] << "  ";
+        cout << endl;
+        planAdd(k, &cnt[0]);
+    }
+
+    return objval;
+}
+
+/**************************************************************************/
+/*  Pattern enumeration model: one integer variable per maximal pattern   */
+/**************************************************************************/
+double solveEnum() {
+    int i, k, npat, ub, starttime;
+    double objval;
+    char name[32];
+    vector<vector<int> > pats;
+    vector<XPRBvar> x;
+    XPRBexpr le;
+    XPRBprob pe("CutEnum");
+
+    starttime = XPRB::getTime();
+    npat = enumPatterns(ENUMMAXPAT, pats);
+    if (npat > ENUMMAXPAT) {
+        cout << "Enumeration: more than " << ENUMMAXPAT << " patterns." << endl;
+        return -1;
+    }
+
+    /****VARIABLES****/
+    x.resize(npat);
+    for (k = 0; k < npat; k++) {
+        ub = 0;
+        for (i = 0; i < NWIDTHS; i++)
+            if (pats[k][i] > 0 && (int) ceil((double) DEMAND[i] / pats[k][i]) > ub)
+                ub = (int) ceil((double) DEMAND[i] / pats[k][i]);
+        snprintf(name, sizeof(name), "pat_%d", k + 1);
+        x[k] = pe.newVar(name, XPRB_UI, 0, ub);
+    }
+
+    /****OBJECTIVE****/
+    for (k = 0; k < npat; k++)
+        le += x[k];                       /* Minimize total number of rolls */
+    pe.setObj(pe.newCtr("OBJ", le));
+
+    /****CONSTRAINTS****/
+    for (i = 0; i < NWIDTHS; i++) {       /* Satisfy the demand per width */
+        le = 0;
+        for (k = 0; k < npat; k++)
+            if (pats[k][i] > 0) le += pats[k][i] * x[k];
+        pe.newCtr("Demand", le >= DEMAND[i]);
+    }
+
+    xbApplyParams(pe.getXPRSprob(), &PARAMS);
+    if (race != NULL) raceAttach(pe, ENG_ENUM, 1);
+    pe.mipOptimize("");
+    if (race != NULL) raceMIPDone(pe, ENG_ENUM, 1);
+    if (pe.getMIPStat() != XPRB_MIP_OPTIMAL && pe.getMIPStat() != XPRB_MIP_SOLUTION) return -1;
+    objval = pe.getObjVal();
+    cout << "(" << (XPRB::getTime() - starttime) / 1000.0 << " sec) Enumeration: " << objval
+         << " rolls, " << npat << " patterns" << endl;
+    for (k = 0; k < npat; k++)
+        if (x[k].getSol() > 0.5) {
+            cout << "   " << x[k].getSol() << " x  ";
+            for (i = 0; i < NWIDTHS; i++)
+                if (pats[k][i] > 0) cout << WIDTH[i] << ":" << pats[k][i] << "  ";
+            cout << endl;
+            planAdd((int) floor(x[k].getSol() + 0.5), &pats[k][0]);
+        }
+
+    return objval;
+}
+
+/**************************************************************************/
+/*  Instance features used by the engine selector                         */
+/**************************************************************************/
+void getFeatures(CSFeatures *f) {
+    int j;
+    vector<int> tail, head, item;
+    vector<vector<int> > pats;
+    double minw, maxw;
+
+    minw = maxw = WIDTH[0];
+    f->totdemand = 0;
+    for (j = 0; j < NWIDTHS; j++) {
+        minw = min(minw, WIDTH[j]);
+        maxw = max(maxw, WIDTH[j]);
+        f->totdemand += DEMAND[j];
+    }
+    f->nwidths = NWIDTHS;
+    f->minratio = minw / MAXWIDTH;
+    f->maxratio = maxw / MAXWIDTH;
+    f->itemsperroll = floor(MAXWIDTH / minw + EPS);
+    f->scale = getScale();
+    if (f->scale == 0)
+        f->arcs = -1;
+    else if (MAXWIDTH * f->scale * NWIDTHS > 10 * ARCMAXARCS)
+        f->arcs = MAXWIDTH * f->scale * NWIDTHS;     /* Estimate only */
+    else {
+        buildArcFlow(f->scale, tail, head, item);
+        f->arcs = tail.size();
+    }
+    f->npatterns = enumPatterns(ENUMMAXPAT, pats);
+}
+
+/* Selector input: bias followed by scaled features */
+void featureVector(const CSFeatures *f, double *v) {
+    v[0] = 1;
+    v[1] = log(1.0 + f->nwidths);
+    v[2] = log(1.0 + f->totdemand);
+    v[3] = f->minratio;
+    v[4] = f->maxratio;
+    v[5] = log(1.0 + f->itemsperroll);
+    v[6] = f->arcs < 0 ? 0 : log(1.0 + f->arcs);
+    v[7] = log(1.0 + f->npatterns);
+}
+
+/**************************************************************************/
+/*  Trained selector: per engine a linear model of log(solution time)     */
+/*  over the feature vector, read from a file with one line per engine:   */
+/*  'name w0 ... w7'                                                      */
+/**************************************************************************/
+int readSelectorModel(const char *fname) {
+    int e, k, n = 0;
+    char name[64];
+    double w[NFEATURES];
+    ifstream in(fname);
+
+    while (in >> setw(64) >> name) {
+        for (k = 0; k < NFEATURES; k++)
+            if (!(in >> w[k])) break;
+        if (k < NFEATURES) break;
+        for (e = 0; e < NENGINES && strcmp(name, ENGNAME[e]); e++);
+        if (e == NENGINES) continue;
+        for (k = 0; k < NFEATURES; k++) SELWEIGHT[e][k] = w[k];
+        SELTRAINED[e] = 1;
+        n++;
+    }
+    if (n == 0) cout << "No selector model read from " << fname << endl;
+    return n;
+}
+
+/**************************************************************************/
+/*  Fit the selector from benchmark results: lines 'name v1 ... v7 sec'   */
+/*  as written by -bench. Least squares on log(time), solved by Gaussian  */
+/*  elimination on the (slightly regularized) normal equations.           */
+/**************************************************************************/
+int trainSelector(const char *benchfile, const char *modelfile) {
+    int e, i, k, l, r, nrows[NENGINES];
+    double A[NENGINES][NFEATURES][NFEATURES + 1], v[NFEATURES], sec, piv;
+    char name[64];
+    ifstream in(benchfile);
+    ofstream out(modelfile);
+
+    memset(A, 0, sizeof(A));
+    memset(nrows, 0, sizeof(nrows));
+    while (in >> setw(64) >> name) {
+        v[0] = 1;
+        for (k = 1; k < NFEATURES; k++) in >> v[k];
+        if (!(in >> sec)) break;
+        for (e = 0; e < NENGINES && strcmp(name, ENGNAME[e]); e++);
+        if (e == NENGINES) continue;
+        for (k = 0; k < NFEATURES; k++) {
+            for (l = 0; l < NFEATURES; l++) A[e][k][l] += v[k] * v[l];
+            A[e][k][NFEATURES] += v[k] * log(sec + 1e-3);
+        }
+        nrows[e]++;
+    }
+
+    for (e = 0; e < NENGINES; e++) {
+        if (nrows[e] < NFEATURES) {
+            cout << ENGNAME[e] << ": " << nrows[e] << " results, not trained" << endl;
+            continue;
+        }
+        for (k = 0; k < NFEATURES; k++) A[e][k][k] += 1e-6 * nrows[e];
+        for (k = 0; k < NFEATURES; k++) {        /* Gaussian elimination */
+            for (r = k, i = k + 1; i < NFEATURES; i++)
+                if (fabs(A[e][i][k]) > fabs(A[e][r][k])) r = i;
+            for (l = 0; l <= NFEATURES; l++) swap(A[e][k][l], A[e][r][l]);
+            for (i = 0; i < NFEATURES; i++)
+                if (i != k) {
+                    piv = A[e][i][k] / A[e][k][k];
+                    for (l = k; l <= NFEATURES; l++) A[e][i][l] -= piv * A[e][k][l];
+                }
+        }
+        out << ENGNAME[e];
+        for (k = 0; k < NFEATURES; k++) out << " " << A[e][k][NFEATURES] / A[e][k][k];
+        out << endl;
+        cout << ENGNAME[e] << ": trained on " << nrows[e] << " results" << endl;
+    }
+    return 0;
+}
+
+/**************************************************************************/
+/*  Route the instance to the engine predicted fastest: by the trained    */
+/*  models if available, by rules on the instance profile otherwise.      */
+/*  The decision is logged to SELECTLOG.                                  */
+/**************************************************************************/
+int selectEngine(const CSFeatures *f, const char *inst) {
+    int e, k, engine = -1;
+    double v[NFEATURES], pred[NENGINES];
+    const char *reason;
+    ofstream log(SELECTLOG, ios::app);
+
+    featureVector(f, v);
+    for (e = 0; e < NENGINES; e++) {
+        pred[e] = 0;
+        for (k = 0; k < NFEATURES; k++) pred[e] += SELWEIGHT[e][k] * v[k];
+        if (!SELTRAINED[e] || (e == ENG_ENUM && f->npatterns > ENUMMAXPAT) ||
+            ((e == ENG_ARCFLOW || e == ENG_DPPRICE) && f->scale == 0))
+            continue;                            /* No model or not applicable */
+        if (engine < 0 || pred[e] < pred[engine]) engine = e;
+    }
+
+    if (engine >= 0)
+        reason = "trained model";
+    else if (f->npatterns <= ENUMMAXPAT) {
+        engine = ENG_ENUM;                       /* Few wide items */
+        reason = "few maximal patterns";
+    } else if (f->scale > 0 && f->arcs <= ARCMAXARCS) {
+        engine = ENG_ARCFLOW;
+        reason = "small arc-flow graph";
+    } else if (f->scale > 0 && MAXWIDTH * f->scale * f->nwidths * log2(2 + f->totdemand) <= DPMAXCELLS) {
+        engine = ENG_DPPRICE;                    /* Many small items */
+        reason = "integral widths, large graph";
+    } else {
+        engine = ENG_COLGEN;
+        reason = "default";
+    }
+
+    cout << "Engine selected: " << ENGNAME[engine] << " (" << reason << ")" << endl;
+    log << (inst != NULL ? inst : "default") << " widths=" << f->nwidths << " demand=" << f->totdemand
+        << " minratio=" << f->minratio << " maxratio=" << f->maxratio << " perroll=" << f->itemsperroll
+        << " scale=" << f->scale << " arcs=" << f->arcs << " patterns=" << f->npatterns
+        << " -> " << ENGNAME[engine] << " (" << reason;
+    if (SELTRAINED[engine]) log << ", predicted " << exp(pred[engine]) << " sec";
+    log << ")" << endl;
+
+    return engine;
+}
+
+double solveEngine(int engine) {
+    switch (engine) {
+        case ENG_ARCFLOW:
+            return solveArcFlow();
+        case ENG_ENUM:
+            return solveEnum();
+        case ENG_DPPRICE:
+            pricer = knapsackDP;
+            break;
+        default:
+            pricer = knapsack;
+    }
+    modCutStock();                    /* Model the problem */
+    return solveCutStock();           /* Solve the problem */
+}
+
+/**************************************************************************/
+/*  Engine racing: the racers share the best solution value and the best  */
+/*  lower bound through 'race'; once they meet the race is decided and    */
+/*  the optimizer callbacks interrupt the remaining racers. The shared    */
+/*  incumbent is also passed to every MIP as cutoff.                      */
+/**************************************************************************/
+void raceCheck(int engine) {
+    int none = -1;
+
+    if (DETERMINISTIC && engine < NENGINES) return;  /* Decided after the race */
+    if (race->incumbent.load() <= race->bound.load() + EPS &&
+        race->winner.compare_exchange_strong(none, engine))
+        xbCancel(&race->group);                  /* Stop the other racers */
+}
+
+void raceNotify() {
+    if (race->cb != NULL) {
+        lock_guard<mutex> lock(race->cblock);
+        race->cb(race->incumbent.load(), race->bound.load(), race->cbdata);
+    }
+}
+
+/* In deterministic mode racers only record their own results */
+void raceIncumbent(double obj, int engine) {
+    int own = (DETERMINISTIC && engine < NENGINES);
+    atomic<double> &inc = (own ? RACER[engine].incumbent : race->incumbent);
+    double cur = inc.load();
+
+    while (obj < cur)
+        if (inc.compare_exchange_weak(cur, obj)) {
+            if (!own) raceNotify();
+            break;
+        }
+    raceCheck(engine);
+}
+
+void raceBound(double bd, int engine) {
+    int own = (DETERMINISTIC && engine < NENGINES);
+    atomic<double> &bnd = (own ? RACER[engine].bound : race->bound);
+    double cur = bnd.load();
+
+    bd = ceil(bd - EPS);                         /* Number of rolls is integral */
+    while (bd > cur)
+        if (bnd.compare_exchange_weak(cur, bd)) {
+            if (!own) raceNotify();
+            break;
+        }
+    raceCheck(engine);
+}
+
+int raceStopped() {
+    return race != NULL && (xbCancelled(&race->group) ||
+                            (race->deadline > 0 && XPRB::getTime() >= race->deadline));
+}
+
+void XPRS_CC cbRaceNode(XPRSprob xprob, void *data, int *feas) {
+    CSRacer *r = (CSRacer *) data;
+    double bd;
+
+    if (r->exact) {                              /* Share the MIP bound */
+        XPRSgetdblattrib(xprob, XPRS_BESTBOUND, &bd);
+        raceBound(bd, r->engine);
+    }
+    if (race->incumbent.load() < XPRB_INFINITY)  /* Prune with others' solutions */
+        XPRSsetdblcontrol(xprob, XPRS_MIPABSCUTOFF, race->incumbent.load() - 1 + 1e-4);
+    if (raceStopped()) XPRSinterrupt(xprob, XPRS_STOP_USER);
+}
+
+void XPRS_CC cbRaceSol(XPRSprob xprob, void *data) {
+    double obj;
+
+    XPRSgetdblattrib(xprob, XPRS_MIPOBJVAL, &obj);
+    raceIncumbent(obj, ((CSRacer *) data)->engine);
+}
+
+int XPRS_CC cbRaceLP(XPRSprob xprob, void *data) {
+    return raceStopped();                        /* Nonzero stops the LP */
+}
+
+void raceAttach(XPRBprob &prob, int engine, int exact) {
+    XPRSprob xprob = prob.getXPRSprob();
+
+    RACER[engine].engine = engine;
+    RACER[engine].exact = exact;
+    XPRSsetintcontrol(xprob, XPRS_LPLOG, 100);
+    XPRSaddcblplog(xprob, cbRaceLP, &RACER[engine], 0);
+    XPRSaddcboptnode(xprob, cbRaceNode, &RACER[engine], 0);
+    XPRSaddcbintsol(xprob, cbRaceSol, &RACER[engine], 0);
+    if (race->incumbent.load() < XPRB_INFINITY)
+        XPRSsetdblcontrol(xprob, XPRS_MIPABSCUTOFF, race->incumbent.load() - 1 + 1e-4);
+    if (race->deadline > 0)                      /* Hard time limit in seconds */
+        XPRSsetintcontrol(xprob, XPRS_MAXTIME, -max(1, (race->deadline - XPRB::getTime() + 999) / 1000));
+    if (NTHREADS > 0 || DETERMINISTIC)
+        XPRSsetintcontrol(xprob, XPRS_THREADS, NTHREADS > 0 ? NTHREADS : 1);
+    else
+        XPRSsetintcontrol(xprob, XPRS_THREADS, RACER[engine].threads);
+    if (DETERMINISTIC)
+        XPRSsetintcontrol(xprob, XPRS_DETERMINISTIC, 1);
+}
+
+/* Racer task: the optimizer threads come from the core budget */
+void raceWorker(int engine) {
+    RACER[engine].threads = xbAcquireCores(race->threads);
+    solveEngine(engine);
+    RACER[engine].finish = XPRB::getTime();
+    xbReleaseCores(RACER[engine].threads);
+}
+
+/* Deterministic mode: combine the racers' results in engine order. The
+   race is won by the first engine whose results close the gap; the time
+   it finished is when the default mode would have stopped. */
+int raceReduce(int nracers, const int *engines, int *decided) {
+    int i, e, winner = (race->winner.load() >= 0 ? NENGINES : -1);
+
+    *decided = race->start;
+    for (i = 0; i < nracers; i++) {
+        e = engines[i];
+        if (RACER[e].incumbent.load() < race->incumbent.load())
+            race->incumbent = RACER[e].incumbent.load();
+        if (RACER[e].bound.load() > race->bound.load())
+            race->bound = RACER[e].bound.load();
+        if (winner < 0 && race->incumbent.load() <= race->bound.load() + EPS)
+            winner = e;
+    }
+    for (i = 0; i < nracers; i++) {
+        e = engines[i];
+        if (winner >= 0 && (*decided == race->start || RACER[e].finish < *decided) &&
+            RACER[e].incumbent.load() <= race->bound.load() + EPS)
+            *decided = RACER[e].finish;
+    }
+    raceNotify();
+    return winner;
+}
+
+/* Share the result of a completed MIP; for an exact model an infeasible
+   MIP means nothing beats the cutoff, i.e. the shared incumbent */
+void raceMIPDone(XPRBprob &prob, int engine, int exact) {
+    int stat = prob.getMIPStat();
+
+    if (stat == XPRB_MIP_OPTIMAL || stat == XPRB_MIP_SOLUTION)
+        raceIncumbent(prob.getObjVal(), engine);
+    if (exact && stat == XPRB_MIP_OPTIMAL)
+        raceBound(prob.getObjVal(), engine);
+    else if (exact && stat == XPRB_MIP_INFEAS && race->incumbent.load() < XPRB_INFINITY)
+        raceBound(race->incumbent.load(), engine);
+}
+
+/* Run the engines as tasks until one of them closes the gap or the
+   time limit 'maxtime' (msec, 0 for none) is reached */
+double raceEngines(int nracers, const int *engines, int maxtime, CSCallback cb, void *cbdata) {
+    int i, j, starttime, winner, decided;
+    double mat;
+    CSRace r;
+
+    mat = 0;                                     /* Material bound */
+    for (j = 0; j < NWIDTHS; j++) mat += WIDTH[j] * DEMAND[j];
+    starttime = XPRB::getTime();
+    r.incumbent = XPRB_INFINITY;
+    r.bound = ceil(mat / MAXWIDTH - EPS);
+    r.winner = -1;
+    r.start = starttime;
+    r.deadline = (maxtime > 0 ? starttime + maxtime : 0);
+    r.threads = max(1, xbNumThreads() / max(1, nracers));
+    xbGroupInit(&r.group, NULL);
+    r.cb = cb;
+    r.cbdata = cbdata;
+    race = &r;
+    for (i = 0; i < NENGINES; i++) {
+        RACER[i].incumbent = XPRB_INFINITY;
+        RACER[i].bound = 0;
+        RACER[i].finish = starttime;
+        RACER[i].threads = 1;
+    }
+
+    raceIncumbent(greedyRolls(), NENGINES);      /* Heuristic start */
+    cout << "Racing";
+    for (i = 0; i < nracers; i++) cout << " " << ENGNAME[engines[i]];
+    cout << endl;
+    for (i = nracers - 1; i >= 0; i--) {         /* The caller runs the first */
+        int e = engines[i];
+        xbSpawn(&r.group, [e]() { raceWorker(e); });
+    }
+    xbWait(&r.group);
+
+    if (DETERMINISTIC) {
+        r.winner = raceReduce(nracers, engines, &decided);
+        if (r.winner.load() >= 0)
+            cout << "Deterministic mode: " << (XPRB::getTime() - starttime) / 1000.0 << " sec, decided after "
+                 << (decided - starttime) / 1000.0 << " sec (overhead "
+                 << (XPRB::getTime() - decided) / 1000.0 << " sec)" << endl;
+    }
+    race = NULL;
+
+    winner = r.winner.load();
+    cout << "(" << (XPRB::getTime() - starttime) / 1000.0 << " sec) Race ";
+    if (winner >= 0)
+        cout << "won by " << (winner < NENGINES ? ENGNAME[winner] : "heuristic") << ": "
+             << r.incumbent.load() << " rolls (optimal)" << endl;
+    else
+        cout << "undecided: " << r.incumbent.load() << " rolls, bound " << r.bound.load() << endl;
+
+    return r.incumbent.load() < XPRB_INFINITY ? r.incumbent.load() : -1;
+}
+
+/**************************************************************************/
+/*  Anytime solve: the best solution within 'maxtime' msec, 'cb' is       */
+/*  called on each improved solution value or lower bound                 */
+/**************************************************************************/
+double solveCutStockAnytime(int maxtime, CSCallback cb, void *cbdata) {
+    int engine = (getScale() > 0 ? ENG_DPPRICE : ENG_COLGEN);
+
+    return raceEngines(1, &engine, maxtime, cb, cbdata);
+}
+
+/* Racers for an instance: the exact engines that apply to it and one
+   column generation engine (they cannot share the problem 'p') */
+int getRacers(const CSFeatures *f, int *engines) {
+    int n = 0;
+
+    if (f->npatterns <= ENUMMAXPAT) engines[n++] = ENG_ENUM;
+    if (f->scale > 0 && f->arcs <= 10 * ARCMAXARCS) engines[n++] = ENG_ARCFLOW;
+    engines[n++] = (f->scale > 0 ? ENG_DPPRICE : ENG_COLGEN);
+    return n;
 }
 
 /**************************************************************************/
@@ -212,12 +1180,287 @@ double knapsack(int N, double *c, double *a, double R, int *d, int *xbest) {
     return (zbest);
 }
 
+/**************************************************************************/
+/* Greedy heuristic for the same knapsack problem: items by decreasing    */
+/* profit per unit of resource, each as often as it fits                 */
+/**************************************************************************/
+double knapsackGreedy(int N, double *c, double *a, double R, int *d, int *xbest) {
+    int j, k;
+    int order[MAXNWIDTHS];
+    double z = 0;
+
+    for (j = 0; j < N; j++) order[j] = j;
+    for (j = 1; j < N; j++)
+        for (k = j; k > 0 && c[order[k]] / a[order[k]] > c[order[k - 1]] / a[order[k - 1]]; k--)
+            swap(order[k], order[k - 1]);
+    for (k = 0; k < N; k++) {
+        j = order[k];
+        xbest[j] = (c[j] > EPS ? min(d[j], (int) floor(R / a[j] + EPS)) : 0);
+        R -= xbest[j] * a[j];
+        z += xbest[j] * c[j];
+    }
+    return z;
+}
+
+/**************************************************************************/
+/* Number of rolls used by a sequential heuristic: cut the roll greedily  */
+/* by decreasing width and repeat it while the demand allows             */
+/**************************************************************************/
+double greedyRolls() {
+    int j, k, n, rem[MAXNWIDTHS], x[MAXNWIDTHS];
+    double rolls = 0, prof[MAXNWIDTHS];
+
+    for (j = 0; j < NWIDTHS; j++) {
+        rem[j] = DEMAND[j];
+        prof[j] = WIDTH[j] * WIDTH[j];  /* Widest pieces first */
+    }
+    for (;;) {
+        knapsackGreedy(NWIDTHS, prof, WIDTH, MAXWIDTH, rem, x);
+        for (n = -1, j = 0; j < NWIDTHS; j++)   /* Repetitions of the pattern */
+            if (x[j] > 0 && (n < 0 || rem[j] / x[j] < n)) n = rem[j] / x[j];
+        if (n < 0) break;                       /* All demand satisfied */
+        k = max(n, 1);
+        for (j = 0; j < NWIDTHS; j++) rem[j] = max(0, rem[j] - k * x[j]);
+        rolls += k;
+    }
+    return rolls;
+}
+
+/**************************************************************************/
+/* Same knapsack problem solved by dynamic programming over the (scaled)  */
+/* capacity; bounded items are split into 0/1 items of size 1,2,4,...     */
+/* Falls back to knapsack() if the widths cannot be scaled to integers.   */
+/**************************************************************************/
+double knapsackDP(int N, double *c, double *a, double R, int *d, int *xbest) {
+    int j, k, m, u, W, scale, nparts;
+    vector<int> pitem, pcnt, pw;
+    vector<double> best;
+    vector<char> take;
+
+    scale = getScale();
+    if (scale == 0) return knapsack(N, c, a, R, d, xbest);
+    W = (int) floor(R * scale + EPS);
+
+    for (j = 0; j < N; j++) {                  /* Binary splitting */
+        xbest[j] = 0;
+        if (c[j] <= EPS) continue;             /* No profit from this item */
+        m = min(d[j], (int) floor(R / a[j] + EPS));
+        for (k = 1; m > 0; k *= 2) {
+            pitem.push_back(j);
+            pcnt.push_back(min(k, m));
+            pw.push_back(min(k, m) * (int) floor(a[j] * scale + 0.5));
+            m -= min(k, m);
+        }
+    }
+    nparts = (int) pitem.size();
+
+    best.assign(W + 1, 0.0);
+    take.assign((size_t) nparts * (W + 1), 0);
+    for (k = 0; k < nparts; k++)
+        for (u = W; u >= pw[k]; u--)
+            if (best[u - pw[k]] + pcnt[k] * c[pitem[k]] > best[u] + EPS) {
+                best[u] = best[u - pw[k]] + pcnt[k] * c[pitem[k]];
+                take[(size_t) k * (W + 1) + u] = 1;
+            }
+
+    for (u = W, k = nparts - 1; k >= 0; k--)   /* Recover the solution */
+        if (take[(size_t) k * (W + 1) + u]) {
+            xbest[pitem[k]] += pcnt[k];
+            u -= pw[k];
+        }
+
+    return best[W];
+}
+
+/**************************************************************************/
+/*  Solution cache (see xbcache.h). The key lists the engine, the optimizer */
+/*  controls sorted by name, MAXWIDTH and the widths sorted with their    */
+/*  demands; perm[k] is the input index of the k-th sorted width. A       */
+/*  solution is the number of rolls followed by the number of patterns    */
+/*  and per pattern its rolls and its piece counts in sorted order.       */
+/**************************************************************************/
+void cacheKey(int engine, vector<double> *key, vector<int> *perm) {
+    int j, k;
+    vector<int> prm(PARAMS.name.size());
+
+    key->clear();
+    key->push_back(engine);
+    if (engine == ENG_COLGEN || engine == ENG_DPPRICE)
+        key->push_back(lpEmbedded());           /* Other LP, other columns */
+    for (k = 0; k < (int) prm.size(); k++) prm[k] = k;
+    sort(prm.begin(), prm.end(), [](int a, int b) { return PARAMS.name[a] < PARAMS.name[b]; });
+    key->push_back((double) prm.size());
+    for (k = 0; k < (int) prm.size(); k++) {
+        xbCacheKeyString(key, PARAMS.name[prm[k]]);
+        key->push_back(PARAMS.value[prm[k]]);
+    }
+    perm->resize(NWIDTHS);
+    for (j = 0; j < NWIDTHS; j++) (*perm)[j] = j;
+    sort(perm->begin(), perm->end(), [](int a, int b) {
+        return WIDTH[a] < WIDTH[b] || (WIDTH[a] == WIDTH[b] && DEMAND[a] < DEMAND[b]);
+    });
+    key->push_back(MAXWIDTH);
+    key->push_back(NWIDTHS);
+    for (k = 0; k < NWIDTHS; k++) {
+        key->push_back(WIDTH[(*perm)[k]]);
+        key->push_back(DEMAND[(*perm)[k]]);
+    }
+}
+
+void cacheSolution(double rolls, const vector<int> &perm, vector<double> *sol) {
+    int k, l;
+
+    sol->assign(1, rolls);
+    sol->push_back((double) PLANPAT.size());
+    for (k = 0; k < (int) PLANPAT.size(); k++) {
+        sol->push_back(PLANROLLS[k]);
+        for (l = 0; l < NWIDTHS; l++) sol->push_back(PLANPAT[k][perm[l]]);
+    }
+}
+
+/*  Check a cached solution against the instance and print it.            */
+/*  Return value: 0 if it is not a valid plan with its number of rolls    */
+int cacheCheck(const vector<double> &sol, const vector<int> &perm) {
+    int k, l, npat;
+    double rolls = 0, used;
+    vector<double> cut(NWIDTHS, 0);
+
+    if (sol.size() < 2) return 0;
+    npat = (int) sol[1];
+    if (npat < 1 || (int) sol.size() != 2 + npat * (NWIDTHS + 1)) return 0;
+    for (k = 0; k < npat; k++) {
+        const double *c = &sol[2 + k * (NWIDTHS + 1)];
+        for (used = 0, l = 0; l < NWIDTHS; l++) {
+            used += c[1 + l] * WIDTH[perm[l]];
+            cut[perm[l]] += c[0] * c[1 + l];
+        }
+        if (used > MAXWIDTH + EPS) return 0;      /* Pattern does not fit */
+        rolls += c[0];
+    }
+    for (l = 0; l < NWIDTHS; l++)
+        if (cut[l] < DEMAND[l] - EPS) return 0;   /* Demand not met */
+    if (fabs(rolls - sol[0]) > EPS) return 0;
+
+    cout << "Cached solution: " << sol[0] << " rolls, " << npat << " patterns" << endl;
+    for (k = 0; k < npat; k++) {
+        const double *c = &sol[2 + k * (NWIDTHS + 1)];
+        cout << "   " << c[0] << " x  ";
+        for (l = 0; l < NWIDTHS; l++)
+            if (c[1 + l] > 0) cout << WIDTH[perm[l]] << ":" << c[1 + l] << "  ";
+        cout << endl;
+    }
+    return 1;
+}
+
 /***********************************************************************/
 
 int main(int argc, char **argv) {
-    modCutStock();                    /* Model the problem */
-    solveCutStock();                  /* Solve the problem */
+    int i, e, engine = -1, starttime, dorace = 0, nracers, maxtime = 0;
+    int racers[NENGINES];
+    double objval, v[NFEATURES];
+    int features = 0;
+    const char *datafile = NULL, *benchfile = NULL, *paramfile = "xbcutstk.prm", *cachefile = NULL;
+    CSFeatures feat;
+    vector<double> key, sol;
+    vector<int> perm;
 
-    return 0;
-} 
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-train") && i + 2 < argc)
+            return trainSelector(argv[i + 1], argv[i + 2]);
+        else if (!strcmp(argv[i], "-engine") && i + 1 < argc) {
+            for (e = 0; e < NENGINES && strcmp(argv[i + 1], ENGNAME[e]); e++);
+            if (e == NENGINES) {
+                cout << "Unknown engine " << argv[i + 1] << endl;
+                return 1;
+            }
+            engine = e;
+            i++;
+        } else if (!strcmp(argv[i], "-model") && i + 1 < argc)
+            readSelectorModel(argv[++i]);
+        else if (!strcmp(argv[i], "-race"))
+            dorace = 1;
+        else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-det"))
+            DETERMINISTIC = 1;
+        else if (!strcmp(argv[i], "-bench") && i + 1 < argc)
+            benchfile = argv[++i];
+        else if (!strcmp(argv[i], "-params") && i + 1 < argc)
+            paramfile = argv[++i];
+        else if (!strcmp(argv[i], "-features"))
+            features = 1;
+        else if (!strcmp(argv[i], "-cache") && i + 1 < argc)
+            cachefile = argv[++i];
+        else if (!strcmp(argv[i], "-lp") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "optimizer"))
+                LPCHOICE = 0;
+            else if (!strcmp(argv[i], "embedded"))
+                LPCHOICE = 1;
+            else if (!strcmp(argv[i], "auto"))
+                LPCHOICE = -1;
+            else {
+                cout << "Unknown LP backend " << argv[i] << endl;
+                return 1;
+            }
+        } else
+            datafile = argv[i];
+    }
+    if (datafile != NULL && !readData(datafile)) return 1;
+    if (features) {
+        getFeatures(&feat);
+        featureVector(&feat, v);
+        cout << "Features:";
+        for (i = 1; i < NFEATURES; i++) cout << " " << v[i];
+        cout << endl;
+        return 0;
+    }
+    if (xbReadParams(paramfile, &PARAMS) > 0)
+        cout << "Optimizer controls from " << paramfile << endl;
+
+    getFeatures(&feat);
+    starttime = XPRB::getTime();
+    if (dorace) {
+        nracers = getRacers(&feat, racers);
+        return raceEngines(nracers, racers, maxtime, maxtime > 0 ? xbPrintProgress : NULL, &starttime) < 0;
+    }
+    if (maxtime > 0)
+        return solveCutStockAnytime(maxtime, xbPrintProgress, &starttime) < 0;
+    if (engine < 0)
+        engine = selectEngine(&feat, datafile);
+
+    if (cachefile != NULL && benchfile == NULL && xbCacheOpen(&CACHE, cachefile)) {
+        cacheKey(engine, &key, &perm);
+        if (xbCacheLookup(&CACHE, key, &sol)) {
+            if (cacheCheck(sol, perm)) {
+                xbCachePrintStats(&CACHE);
+                return XBCACHEHIT;
+            }
+            cout << "Cached solution fails the check, solving." << endl;
+            xbCacheDrop(&CACHE, key);
+        }
+    }
+
+    starttime = XPRB::getTime();
+    objval = solveEngine(engine);
+    if (CACHE.fd >= 0) {
+        if (objval >= 0 && !PLANPAT.empty()) {
+            cacheSolution(objval, perm, &sol);
+            xbCacheStore(&CACHE, key, sol);
+        }
+        xbCachePrintStats(&CACHE);
+        xbCacheClose(&CACHE);
+    }
+
+    if (benchfile != NULL && objval >= 0) {    /* Record a benchmark result */
+        ofstream bench(benchfile, ios::app);
+        featureVector(&feat, v);
+        bench << ENGNAME[engine];
+        for (i = 1; i < NFEATURES; i++) bench << " " << v[i];
+        bench << " " << (XPRB::getTime() - starttime) / 1000.0 << endl;
+    }
 
+    return 0;
+}
@@ -0,0 +1,258 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbdes.h
+  ````````````
+  Discrete-event simulation of a production line that
+  executes a lot sizing plan: at the start of period t
+  the lot prod[t] is released, a lot with a setup first
+  needs the setup time, then the units are processed one
+  at a time; the line breaks down after exponential
+  times between failures and is repaired after
+  exponential repair times, an interrupted setup or unit
+  continues after the repair. The result is the
+  production completed in every period.
+
+  The kernel is a calendar queue (Brown, 1988): the
+  pending events are kept in buckets of a fixed width in
+  time, sorted within a bucket, and the current bucket
+  is scanned for the next event. The number of buckets
+  and the width follow the number of pending events.
+  Events are taken from a pool with a free list and
+  dispatched by a switch on their type. Superseded
+  events (a unit end after a breakdown) are not removed
+  from the queue but ignored by their epoch.
+********************************************************/
+
+#ifndef XBDES_H
+#define XBDES_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#define DESMINBUCKETS 4
+
+typedef struct {
+    double time;
+    int type, arg, epoch;
+    int next;                           /* Next event in bucket or free list */
+} DESEvent;
+
+typedef struct {
+    std::vector<DESEvent> pool;         /* Event objects */
+    int freelist;                       /* First free event, -1 for none */
+    std::vector<int> bucket;            /* First event per bucket, -1 for none */
+    int nb;                             /* Number of buckets (power of 2) */
+    double width;                       /* Width of a bucket in time */
+    int size;                           /* Number of pending events */
+    int cur;                            /* Current bucket */
+    double top;                         /* Upper time limit of the current bucket */
+    double now;                         /* Time of the last event */
+    long nevents;                       /* Number of events processed */
+} DESQueue;
+
+static inline void desInit(DESQueue *q, double width) {
+    q->pool.clear();
+    q->freelist = -1;
+    q->nb = DESMINBUCKETS;
+    q->bucket.assign(q->nb, -1);
+    q->width = width;
+    q->size = 0;
+    q->cur = 0;
+    q->top = width;
+    q->now = 0;
+    q->nevents = 0;
+}
+
+/* Insert event e, sorted within its bucket */
+static inline void desInsert(DESQueue *q, int e) {
+    int b, *pp;
+    double t = q->pool[e].time;
+
+    b = (int) ((int64_t) (t / q->width) & (q->nb - 1));
+    for (pp = &q->bucket[b]; *pp >= 0 && q->pool[*pp].time <= t; pp = &q->pool[*pp].next);
+    q->pool[e].next = *pp;
+    *pp = e;
+}
+
+/* Rebuild with nb buckets; the width is three times the mean gap of the
+   first events. Scanning restarts at the bucket of the current time. */
+static inline void desResize(DESQueue *q, int nb) {
+    int b, e, n, k;
+    std::vector<int> all;
+    std::vector<double> times;
+
+    for (b = 0; b < q->nb; b++)
+        for (e = q->bucket[b]; e >= 0; e = q->pool[e].next) all.push_back(e);
+    for (k = 0; k < (int) all.size(); k++) times.push_back(q->pool[all[k]].time);
+    std::sort(times.begin(), times.end());
+    n = std::min((int) times.size(), 25);
+    if (n > 1 && times[n - 1] > times[0])
+        q->width = 3 * (times[n - 1] - times[0]) / (n - 1);
+
+    q->nb = nb;
+    q->bucket.assign(nb, -1);
+    for (k = 0; k < (int) all.size(); k++) desInsert(q, all[k]);
+    q->cur = (int) ((int64_t) (q->now / q->width) & (nb - 1));
+    q->top = (floor(q->now / q->width) + 1) * q->width;
+}
+
+static inline void desSchedule(DESQueue *q, double time, int type, int arg, int epoch) {
+    int e;
+
+    if (q->freelist >= 0) {
+        e = q->freelist;
+        q->freelist = q->pool[e].next;
+    } else {
+        e = (int) q->pool.size();
+        q->pool.push_back(DESEvent());
+    }
+    q->pool[e].time = time;
+    q->pool[e].type = type;
+    q->pool[e].arg = arg;
+    q->pool[e].epoch = epoch;
+    desInsert(q, e);
+    if (++q->size > 2 * q->nb) desResize(q, 2 * q->nb);
+}
+
+/**************************************************************************/
+/* Remove the earliest event and copy it to *ev.                          */
+/* Return value: 0 if the queue is empty                                  */
+/**************************************************************************/
+static inline int desNext(DESQueue *q, DESEvent *ev) {
+    int i, b, e, best;
+
+    if (q->size == 0) return 0;
+    for (;;) {
+        for (i = 0; i < q->nb; i++) {           /* One year of buckets */
+            e = q->bucket[q->cur];
+            if (e >= 0 && q->pool[e].time < q->top) {
+                q->bucket[q->cur] = q->pool[e].next;
+                *ev = q->pool[e];
+                q->now = ev->time;
+                q->pool[e].next = q->freelist;
+                q->freelist = e;
+                q->nevents++;
+                if (--q->size < q->nb / 2 && q->nb > DESMINBUCKETS) desResize(q, q->nb / 2);
+                return 1;
+            }
+            q->cur = (q->cur + 1) & (q->nb - 1);
+            q->top += q->width;
+        }
+        best = -1;                              /* Far ahead: jump */
+        for (b = 0; b < q->nb; b++)
+            if (q->bucket[b] >= 0 && (best < 0 || q->pool[q->bucket[b]].time < q->pool[q->bucket[best]].time))
+                best = b;
+        q->cur = best;
+        q->top = (floor(q->pool[q->bucket[best]].time / q->width) + 1) * q->width;
+        if (q->top <= q->pool[q->bucket[best]].time) q->top += q->width;   /* Rounding of t/width */
+    }
+}
+
+/**************************************************************************/
+/* Production line                                                        */
+/**************************************************************************/
+typedef struct {
+    double plen;                        /* Length of a period */
+    double ptime;                       /* Mean processing time per unit */
+    double stime;                       /* Mean setup time */
+    double mtbf, mttr;                  /* Mean time between failures, to repair */
+} DESLine;
+
+#define DES_PERIOD 0
+#define DES_SETUP  1
+#define DES_UNIT   2
+#define DES_FAIL   3
+#define DES_REPAIR 4
+
+/* xorshift64* generator: uniform in (0,1) */
+static inline double desRand(uint64_t *st) {
+    *st ^= *st >> 12;
+    *st ^= *st << 25;
+    *st ^= *st >> 27;
+    return ((*st * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + 1e-17;
+}
+
+/**************************************************************************/
+/* Simulate the plan (prod[t], setup[t]) over T periods; out[t*stride] is */
+/* set to the production completed in period t.                           */
+/* Return value: number of events                                          */
+/**************************************************************************/
+static inline long desRunPlan(DESQueue *q, const DESLine *ln, int T, const double *prod, const int *setup,
+                              uint64_t seed, double *out, int stride) {
+    int t, period = 0, lot = 0, epoch = 0, busy = 0, down = 0, job = 0;
+    double now = 0, qty = 0, jobend = 0, jobleft = 0;
+    std::vector<double> left(T, 0.0);
+    std::vector<int> needsetup(T, 0);
+    uint64_t st = seed * 0x9E3779B97F4A7C15ULL + 1;
+    DESEvent ev;
+
+    /* Start the next setup or unit; lots in order of release */
+    auto start = [&]() {
+        while (lot <= period && left[lot] <= 1e-9 && !needsetup[lot]) lot++;
+        busy = (lot <= period);
+        if (!busy) return;
+        if (needsetup[lot]) {
+            job = DES_SETUP;
+            jobend = now + ln->stime * (0.5 + desRand(&st));
+        } else {
+            job = DES_UNIT;
+            qty = std::min(1.0, left[lot]);
+            jobend = now + qty * ln->ptime * (0.8 + 0.4 * desRand(&st));
+        }
+        desSchedule(q, jobend, job, lot, epoch);
+    };
+
+    for (t = 0; t < T; t++) out[(size_t) t * stride] = 0;
+    desInit(q, ln->plen / 4);
+    desSchedule(q, 0, DES_PERIOD, 0, 0);
+    desSchedule(q, -log(desRand(&st)) * ln->mtbf, DES_FAIL, 0, 0);
+
+    while (desNext(q, &ev)) {
+        now = ev.time;
+        switch (ev.type) {
+            case DES_PERIOD:                    /* Release the lot of the period */
+                if (ev.arg >= T) return q->nevents;   /* End of the horizon */
+                period = ev.arg;
+                left[period] = prod[period];
+                needsetup[period] = (setup[period] && prod[period] > 0);
+                desSchedule(q, (period + 1) * ln->plen, DES_PERIOD, period + 1, 0);
+                if (!busy && !down) start();
+                break;
+            case DES_SETUP:
+                if (ev.epoch != epoch) break;   /* Superseded by a breakdown */
+                needsetup[ev.arg] = 0;
+                start();
+                break;
+            case DES_UNIT:
+                if (ev.epoch != epoch) break;
+                out[(size_t) period * stride] += qty;
+                left[ev.arg] -= qty;
+                start();
+                break;
+            case DES_FAIL:
+                down = 1;
+                if (busy) {                     /* Interrupt the current job */
+                    jobleft = jobend - now;
+                    epoch++;
+                }
+                desSchedule(q, now - log(desRand(&st)) * ln->mttr, DES_REPAIR, 0, 0);
+                break;
+            case DES_REPAIR:
+                down = 0;
+                desSchedule(q, now - log(desRand(&st)) * ln->mtbf, DES_FAIL, 0, 0);
+                if (busy) {                     /* Continue the interrupted job */
+                    jobend = now + jobleft;
+                    desSchedule(q, jobend, job, lot, epoch);
+                } else
+                    start();
+                break;
+        }
+    }
+    return q->nevents;
+}
+
+#endif
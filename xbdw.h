@@ -0,0 +1,196 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbdw.h
+  ```````````
+  Dantzig-Wolfe column generation for the lot sizing
+  solvers (xbcls.cxx, xbpmls.cxx). A column is the plan
+  of item i in block b (e.g. a machine); the master
+  keeps one convexity row per item (dual alpha[i]) and
+  the linking rows with a capacity (duals pi <= 0),
+  and starts from an artificial column per item at cost
+  bigm and the plans at zero duals.
+
+  The solver supplies the pricing as a callback: the
+  best plan of item i in block b under the linking
+  duals pi (NULL for zero duals), with its cost under
+  the duals. The (block, item) pairs are priced in
+  parallel chunks of 'grain' pairs, and the columns
+  with negative reduced cost are added in pair order so
+  that runs are reproducible. The Lagrangian bound is
+  the master value plus the smallest reduced cost of
+  every item over the blocks. The loop ends when no
+  column enters or the master value is within
+  'minimprove' (relative) of the bound; the master MIP
+  over the generated columns then gives a solution.
+********************************************************/
+
+#ifndef XBDW_H
+#define XBDW_H
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbthreads.h"
+
+#define DWRCTOL 1e-4                    /* Reduced cost a column must go below (neg.) */
+
+typedef struct {                        /* Plan of item i in block b */
+    int b, i;
+    double cost;                        /* Cost in the objective */
+    int row0;                           /* First linking row used */
+    std::vector<double> use;            /* Use of the linking rows row0.. */
+    std::vector<double> prod;
+    std::vector<int> setup;
+    ::dashoptimization::XPRBvar lam;
+} DWCol;
+
+typedef std::function<double(int b, int i, const double *pi, DWCol *col)> DWPricer;
+
+typedef struct {
+    ::dashoptimization::XPRBprob *prob; /* Master problem */
+    int nitems, nblocks;
+    std::vector<double> cap;            /* Linking rows: use <= cap */
+    double bigm;                        /* Cost of the artificial columns */
+    int maxpass;                        /* Max. number of pricing rounds */
+    int grain;                          /* Pairs per pricing chunk */
+    int nthreads;                       /* Pricing threads, 0 for one per core */
+    double minimprove;                  /* Stop at this gap (rel.), 0: no column only */
+    std::vector<DWCol> cols;            /* Columns of the master */
+    std::vector<::dashoptimization::XPRBctr> conv, link;
+    ::dashoptimization::XPRBctr cobj;
+} DWMaster;
+
+static inline void dwInit(DWMaster *dw, ::dashoptimization::XPRBprob *prob, int nitems, int nblocks,
+                          const std::vector<double> &cap) {
+    dw->prob = prob;
+    dw->nitems = nitems;
+    dw->nblocks = nblocks;
+    dw->cap = cap;
+    dw->bigm = 1e7;
+    dw->maxpass = 500;
+    dw->grain = 1;
+    dw->nthreads = 0;
+    dw->minimprove = 0;
+    dw->cols.clear();
+}
+
+/* Add the column to the master */
+static inline void dwAddColumn(DWMaster *dw, DWCol &col) {
+    size_t t;
+
+    col.lam = dw->prob->newVar(::dashoptimization::XPRBnewname("lam%d_%d_%d", col.b + 1, col.i + 1,
+                                                                (int) dw->cols.size() + 1), XPRB_BV);
+    dw->cobj += col.cost * col.lam;
+    dw->conv[col.i] += col.lam;
+    for (t = 0; t < col.use.size(); t++)
+        if (col.use[t] > 1e-6) dw->link[col.row0 + t] += col.use[t] * col.lam;
+    dw->cols.push_back(col);
+}
+
+/* Master with an artificial column and the plans at zero duals per item */
+static inline void dwModel(DWMaster *dw, const DWPricer &price) {
+    int b, i, k;
+    ::dashoptimization::XPRBvar art;
+    ::dashoptimization::XPRBexpr le;
+    DWCol col;
+
+    dw->conv.resize(dw->nitems);
+    dw->link.resize(dw->cap.size());
+    for (i = 0; i < dw->nitems; i++) {
+        art = dw->prob->newVar(::dashoptimization::XPRBnewname("art%d", i + 1));
+        le += dw->bigm * art;
+        dw->conv[i] = dw->prob->newCtr(::dashoptimization::XPRBnewname("Conv%d", i + 1), art == 1);
+    }
+    dw->cobj = dw->prob->newCtr("OBJ", le);
+    dw->prob->setObj(dw->cobj);
+    for (k = 0; k < (int) dw->cap.size(); k++)
+        dw->link[k] = dw->prob->newCtr(::dashoptimization::XPRBnewname("Link%d", k + 1),
+                                       ::dashoptimization::XPRBexpr() <= dw->cap[k]);
+
+    for (b = 0; b < dw->nblocks; b++)
+        for (i = 0; i < dw->nitems; i++) {
+            price(b, i, NULL, &col);
+            dwAddColumn(dw, col);
+        }
+}
+
+/**************************************************************************/
+/*  Column generation loop:                                               */
+/*    solve the LP and save the basis                                     */
+/*    get the duals of the convexity and linking rows                     */
+/*    price all (block, item) pairs in parallel                           */
+/*    add the columns with negative reduced cost in pair order            */
+/*    load the modified problem and load the saved basis                  */
+/*  followed by the master MIP (time limit maxtime sec, 0 for none).      */
+/*  Return value: Lagrangian lower bound                                  */
+/**************************************************************************/
+static inline double dwSolve(DWMaster *dw, const DWPricer &price, int maxtime, CLSStats *stats) {
+    int b, i, npass, nnew, N = dw->nitems, NB = dw->nblocks;
+    double objval = 0, lb = -XPRB_INFINITY, z, minrc, t0;
+    std::vector<double> alpha(N), pi(dw->cap.size()), rc(NB * N);
+    std::vector<DWCol> plan(NB * N);
+    ::dashoptimization::XPRBbasis basis;
+    ::dashoptimization::XPRBprob *p = dw->prob;
+
+    t0 = clsClock();
+    dwModel(dw, price);
+    clsRecord(stats, "DW master setup", clsClock() - t0, (long) dw->cols.size());
+
+    for (npass = 1; npass <= dw->maxpass; npass++) {
+        t0 = clsClock();
+        p->lpOptimize("");             /* Solve the LP */
+        basis = p->saveBasis();        /* Save the current basis */
+        objval = p->getObjVal();       /* Get the objective value */
+        for (i = 0; i < N; i++)        /* Get the duals */
+            alpha[i] = dw->conv[i].getDual();
+        for (i = 0; i < (int) pi.size(); i++)
+            pi[i] = std::min(0.0, dw->link[i].getDual());
+        clsRecord(stats, "DW master LP", clsClock() - t0, 1);
+
+        t0 = clsClock();               /* Price the pairs in parallel */
+        xbParallelChunks(NB * N, dw->grain, dw->nthreads, [&](int lo, int hi, int c) {
+            for (int k = lo; k < hi; k++)
+                rc[k] = price(k / N, k % N, &pi[0], &plan[k]) - alpha[k % N];
+        });
+        nnew = 0;
+        for (b = 0; b < NB; b++)       /* Merge in pair order */
+            for (i = 0; i < N; i++)
+                if (rc[b * N + i] < -DWRCTOL) {
+                    dwAddColumn(dw, plan[b * N + i]);
+                    nnew++;
+                }
+        clsRecord(stats, "DW pricing", clsClock() - t0, nnew);
+
+        z = objval;                    /* Lagrangian bound */
+        for (i = 0; i < N; i++) {
+            for (minrc = dw->bigm, b = 0; b < NB; b++) minrc = std::min(minrc, rc[b * N + i]);
+            z += minrc;
+        }
+        lb = std::max(lb, z);
+
+        std::cout << "DW pass " << npass << ": master " << objval << ", bound " << lb << ", new columns "
+                  << nnew << std::endl;
+        if (nnew == 0 || (dw->minimprove > 0 && objval - lb < dw->minimprove * fabs(objval))) break;
+
+        p->loadMat();                  /* Reload the problem */
+        p->loadBasis(basis);           /* Load the saved basis */
+        basis.reset();                 /* No need to keep the basis any longer */
+    }
+    basis.reset();
+
+    t0 = clsClock();                   /* Master MIP over the columns */
+    if (maxtime > 0)
+        XPRSsetintcontrol(p->getXPRSprob(), XPRS_MAXTIME, -maxtime);
+    p->mipOptimize("");
+    clsRecord(stats, "DW master MIP", clsClock() - t0, 1);
+    return lb;
+}
+
+#endif
@@ -18,43 +18,147 @@
   in period t is PRODCOST[t]. There is no inventory
   or stock-holding cost.
 
+  The built-in instance has 6 periods; -gen T seed
+  solves a random instance of T periods instead.
+
+  solveElsAnytime() runs the same loop against a
+  wall-clock limit, starting from the Wagner-Whitin
+  plan and reporting each improved solution or bound
+  through a callback.
+
+  The search for violated (l,S)-inequalities runs in
+  parallel on horizons of PARMINPERIODS periods or more
+  (e.g. -gen 200 1), serially on shorter ones such as
+  the built-in instance. With -det the work
+  partitioning, the order of the cuts and the optimizer
+  thread settings are fixed so that runs are
+  reproducible; on a parallel search its overhead
+  against the default mode is reported at the end.
+
+  parEls() computes in one sweep, for every period, the
+  optimal cost as a function of a change of its setup
+  or unit production cost (breakpoints and linear
+  pieces). With -whatif a batch of queries 'setup t x'
+  or 'prod t x' is answered from these curves.
+
+  With -dynamic a sequence of single-period updates
+  'demand t x', 'setup t x' or 'prod t x' is applied to
+  a dynamic Wagner-Whitin structure (see xbww.h) that
+  re-optimizes the plan after each update.
+
+  The optimizer controls set below (no cuts, no
+  presolve) are defaults; settings in xbels.prm or the
+  file given with -params override them (see
+  xbparams.h).
+
+  With -cache, solutions of runs without time limit are
+  kept in a solution cache file (see xbcache.h) under
+  the demand and cost series and the optimizer
+  controls; a repeated instance is answered from the
+  cache after checking the plan against it, and the run
+  exits with status XBCACHEHIT.
+
+  Usage: xbels [-gen T seed] [-maxtime ms] [-threads n]
+               [-det] [-params file] [-cache file]
+         xbels [-gen T seed] -whatif queryfile
+         xbels [-gen T seed] -dynamic updatefile
+
   (c) 2008 Fair Isaac Corporation
       author: S.Heipcke, 2001, rev. Mar. 2011
 ********************************************************/
 
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <mutex>
 #include "xprb_cpp.h"
 #include "xprs.h"
+#include "xbww.h"
+#include "xbthreads.h"
+#include "xbparams.h"
+#include "xbcache.h"
+#include "xbanytime.h"
 
 using namespace std;
 using namespace ::dashoptimization;
 
 #define EPS    1e-6
 
-#define T 6                             /* Number of time periods */
+#define DETGRAIN 16                     /* Periods per separation chunk */
+#define PARMINPERIODS 64                /* Fewer periods: separate serially */
 
 /****DATA****/
-int DEMAND[] = {1, 3, 5, 3, 4, 2};  /* Demand per period */
-int SETUPCOST[] = {17, 16, 11, 6, 9, 6};  /* Setup cost per period */
-int PRODCOST[] = {5, 3, 2, 1, 3, 1};  /* Production cost per period */
+int T = 6;                              /* Number of time periods */
+vector<int> DEMAND = {1, 3, 5, 3, 4, 2};  /* Demand per period */
+vector<int> SETUPCOST = {17, 16, 11, 6, 9, 6};  /* Setup cost per period */
+vector<int> PRODCOST = {5, 3, 2, 1, 3, 1};  /* Production cost per period */
 //第一维是time period，第二维是从第一维开始到第二维的累加需求
-int D[T][T];                            /* Total demand in periods t1 - t2 */
+vector<vector<int> > D;                 /* Total demand in periods t1 - t2 */
 
-XPRBvar prod[T];                        /* Production in period t */
-XPRBvar setup[T];                       /* Setup in period t */
+vector<XPRBvar> prod;                   /* Production in period t */
+vector<XPRBvar> setup;                  /* Setup in period t */
 
 XPRBprob p("Els");                      /* Initialize a new problem in BCL */
 
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+int DETERMINISTIC = 0;                  /* Reproducible parallel mode */
+XBParams PARAMS;                        /* Tuned optimizer controls */
+vector<double> PLANPROD;                /* Plan of the last solve */
+vector<double> PLANSETUP;
+
+typedef void (*ELSCallback)(double obj, double bound, void *data);
+
+#define WI_SETUP 0                      /* What-if on a setup cost */
+#define WI_PROD  1                      /* What-if on a unit production cost */
+
+typedef struct {
+    vector<double> slope, icpt;         /* Pieces of the cost curve */
+    vector<double> bp;                  /* bp[k]: change where piece k+1 starts */
+} ELSCurve;
+
+vector<ELSCurve> CURVE[2];              /* Cost curves per what-if type, period */
+
 /***********************************************************************/
 
+/* Random instance of nt periods: about 20% zero demands */
+void genEls(int nt, unsigned seed) {
+    int t;
+    mt19937 rng(seed);
+    uniform_real_distribution<double> U(0.0, 1.0);
+
+    T = nt;
+    DEMAND.resize(T);
+    SETUPCOST.resize(T);
+    PRODCOST.resize(T);
+    for (t = 0; t < T; t++) {
+        DEMAND[t] = (U(rng) < 0.2 ? 0 : (int) (1 + 9 * U(rng)));
+        SETUPCOST[t] = (int) (5 + 20 * U(rng));
+        PRODCOST[t] = (int) (1 + 5 * U(rng));
+    }
+}
+
+void calcD() {
+    int s, t;
+
+    D.assign(T, vector<int>(T, 0));
+    for (s = 0; s < T; s++)
+        for (t = s; t < T; t++)
+            D[s][t] = (t > s ? D[s][t - 1] : 0) + DEMAND[t];
+}
+
 void modEls() {
-    int s, t, k;
+    int s, t;
     XPRBexpr cobj, le;
 
-    for (s = 0; s < T; s++)
-        for (t = 0; t < T; t++)
-            for (k = s; k <= t; k++)
-                D[s][t] += DEMAND[k];
+    calcD();
+    prod.resize(T);
+    setup.resize(T);
 
 /****VARIABLES****/
     for (t = 0; t < T; t++) {
@@ -85,6 +189,75 @@ void modEls() {
 
 }
 
+/* Whether the (l,S)-inequality of period l is violated */
+int violatedLS(const double *solprod, const double *solsetup, int l) {
+    int t;
+    double ds;
+
+    for (ds = 0.0, t = 0; t <= l; t++) {
+        if (solprod[t] < D[t][l] * solsetup[t] + EPS) ds += solprod[t];
+        else ds += D[t][l] * solsetup[t];
+    }
+    return ds < D[0][l] - EPS;
+}
+
+/**************************************************************************/
+/*  Search for violated (l,S)-inequalities: the minimum of the actual     */
+/*  production prod[t] and the maximum potential production               */
+/*  D[t][l]*setup[t] in periods 0 to l must at least equal the total      */
+/*  demand in periods 0 to l.                                             */
+/*    sum(t=1:l) min(prod[t], D[t][l]*setup[t]) >= D[0][l]                */
+/*  From PARMINPERIODS periods on, periods l are checked in parallel. In  */
+/*  deterministic mode they are split into fixed chunks whose results are */
+/*  merged in chunk order, otherwise cuts are collected in the order they */
+/*  are found.                                                            */
+/*  Return value: periods l with a violated inequality in 'viol'          */
+/**************************************************************************/
+void separateLS(const double *solprod, const double *solsetup, vector<int> &viol) {
+    int k, l, nchunks;
+    mutex m;
+
+    viol.clear();
+    if (T < PARMINPERIODS) {                 /* Checks too small to share out */
+        for (l = 0; l < T; l++)
+            if (violatedLS(solprod, solsetup, l)) viol.push_back(l);
+    } else if (DETERMINISTIC) {
+        vector<vector<int> > part((T + DETGRAIN - 1) / DETGRAIN);
+        nchunks = xbParallelChunks(T, DETGRAIN, NTHREADS, [&](int lo, int hi, int c) {
+            for (int l = lo; l < hi; l++)
+                if (violatedLS(solprod, solsetup, l)) part[c].push_back(l);
+        });
+        for (k = 0; k < nchunks; k++)        /* Ordered reduction */
+            viol.insert(viol.end(), part[k].begin(), part[k].end());
+    } else
+        xbParallelChunks(T, 1, NTHREADS, [&](int lo, int hi, int c) {
+            if (violatedLS(solprod, solsetup, lo)) {
+                lock_guard<mutex> lock(m);
+                viol.push_back(lo);
+            }
+        });
+}
+
+/* Time the separation on a given LP solution in both modes */
+void reportOverhead(const double *solprod, const double *solsetup) {
+    int r, mode, starttime, msec[2];
+    vector<int> viol;
+
+    for (mode = 0; mode < 2; mode++) {
+        DETERMINISTIC = mode;
+        starttime = XPRB::getTime();
+        for (r = 0; r < 1000; r++)
+            separateLS(solprod, solsetup, viol);
+        msec[mode] = XPRB::getTime() - starttime;
+    }
+    DETERMINISTIC = 1;
+    cout << "Separation (1000 rounds): " << msec[0] / 1000.0 << " sec default, ";
+    cout << msec[1] / 1000.0 << " sec deterministic";
+    if (msec[0] > 0)
+        cout << " (overhead " << 100.0 * (msec[1] - msec[0]) / msec[0] << "%)";
+    cout << endl;
+}
+
 /**************************************************************************/
 /*  Cut generation loop at the top node:                                  */
 /*    solve the LP and save the basis                                     */
@@ -92,31 +265,66 @@ void modEls() {
 /*    identify and set up violated constraints                            */
 /*    load the modified problem and load the saved basis                  */
 /**************************************************************************/
-void solveEls() {
+/*  With a time limit 'maxtime' (msec, 0 for none) the Wagner-Whitin plan */
+/*  is the starting incumbent and the loop stops when the next pass is    */
+/*  not expected to finish in time. 'cb' is called on each improved       */
+/*  solution value or LP bound. Return value: best solution value         */
+/**************************************************************************/
+double solveElsAnytime(int maxtime, ELSCallback cb, void *cbdata) {
     double objval;               /* Objective value */
-    int t, l;
-    int starttime;
-    int ncut, npass, npcut;      /* Counters for cuts and passes */
-    double solprod[T], solsetup[T];   /* Solution values for var.s prod & setup */
-    double ds;
+    int t, l, k;
+    int starttime, deadline, passtime;
+    int ncut, npass, npcut, lastpass;  /* Counters for cuts and passes */
+    vector<double> solprod(T), solsetup(T);   /* Solution values for var.s prod & setup */
+    double best, bound;
+    vector<double> dem(T), sc(T), pc(T), hprod(T);
+    vector<int> hsetup(T);
     XPRBbasis basis;
     XPRBexpr le;
+    vector<int> viol;
 
     starttime = XPRB::getTime();
+    deadline = (maxtime > 0 ? starttime + maxtime : 0);
+    bound = -XPRB_INFINITY;
+    for (t = 0; t < T; t++) {    /* Heuristic plan available at once */
+        dem[t] = DEMAND[t];
+        sc[t] = SETUPCOST[t];
+        pc[t] = PRODCOST[t];
+    }
+    best = wwSolve(T, &dem[0], &sc[0], &pc[0], NULL, &hprod[0], &hsetup[0]);
+    if (cb != NULL) cb(best, bound, cbdata);
+
     XPRSsetintcontrol(p.getXPRSprob(), XPRS_CUTSTRATEGY, 0);
     /* Disable automatic cuts - we use our own */
     XPRSsetintcontrol(p.getXPRSprob(), XPRS_PRESOLVE, 0);
     XPRSsetintcontrol(p.getXPRSprob(), XPRS_MIPPRESOLVE, 0);
     XPRSsetintcontrol(p.getXPRSprob(), XPRS_PREPROBING, 0);
     /* Switch presolve off */
-    ncut = npass = 0;
+    xbApplyParams(p.getXPRSprob(), &PARAMS);    /* Tuned settings */
+    if (DETERMINISTIC) {         /* Fixed optimizer threads */
+        XPRSsetintcontrol(p.getXPRSprob(), XPRS_THREADS, NTHREADS > 0 ? NTHREADS : 1);
+        XPRSsetintcontrol(p.getXPRSprob(), XPRS_DETERMINISTIC, 1);
+    }
+    if (deadline > 0) xbLimitLP(p.getXPRSprob(), &deadline, 1);
+    ncut = npass = npcut = lastpass = 0;
 
     do {
+        passtime = XPRB::getTime();
+        if (deadline > 0) {         /* Time short: keep the heuristic plan */
+            if (npass > 0 && passtime + lastpass > deadline) break;
+            XPRSsetintcontrol(p.getXPRSprob(), XPRS_MAXTIME, -max(1, (deadline - passtime + 999) / 1000));
+            /* MAXTIME is in whole seconds, xbLimitLP stops at the msec */
+        }
         npass++;
         npcut = 0;
         p.lpOptimize("p");          /* Solve the LP */
+        if (p.getLPStat() != XPRB_LP_OPTIMAL) break;
         basis = p.saveBasis();      /* Save the current basis */
         objval = p.getObjVal();     /* Get the objective value */
+        if (objval > bound + EPS) { /* The LP with cuts is a valid bound */
+            bound = objval;
+            if (cb != NULL) cb(best, bound, cbdata);
+        }
 
         /* Get the solution values: */
         for (t = 0; t < T; t++) {
@@ -125,58 +333,401 @@ void solveEls() {
         }
 
         /* Search for violated constraints: */
-        for (l = 0; l < T; l++) {
-            for (ds = 0.0, t = 0; t <= l; t++) {
-                if (solprod[t] < D[t][l] * solsetup[t] + EPS) ds += solprod[t];
-                else ds += D[t][l] * solsetup[t];
-            }
+        separateLS(&solprod[0], &solsetup[0], viol);
 
-            /* Add the violated inequality: the minimum of the actual production
-               prod[t] and the maximum potential production D[t][l]*setup[t]
-               in periods 0 to l must at least equal the total demand in periods
-               0 to l.
-               sum(t=1:l) min(prod[t], D[t][l]*setup[t]) >= D[0][l]
-             */
-            if (ds < D[0][l] - EPS) {
-                le = 0;
-                for (t = 0; t <= l; t++) {
-                    if (solprod[t] < D[t][l] * solsetup[t] + EPS)
-                        le += prod[t];
-                    else
-                        le += D[t][l] * setup[t];
-                }
-                p.newCtr(XPRBnewname("cut%d", ncut + 1), le >= D[0][l]);
-                ncut++;
-                npcut++;
+        /* Add the violated inequalities: */
+        for (k = 0; k < (int) viol.size(); k++) {
+            l = viol[k];
+            le = 0;
+            for (t = 0; t <= l; t++) {
+                if (solprod[t] < D[t][l] * solsetup[t] + EPS)
+                    le += prod[t];
+                else
+                    le += D[t][l] * setup[t];
             }
+            p.newCtr(XPRBnewname("cut%d", ncut + 1), le >= D[0][l]);
+            ncut++;
+            npcut++;
         }
 
         cout << "Pass " << npass << " (" << (XPRB::getTime() - starttime) / 1000.0;
         cout << " sec), objective value " << objval << ", cuts added: " << npcut;
         cout << " (total " << ncut << ")" << endl;
 
-        if (npcut == 0)
+        lastpass = XPRB::getTime() - passtime;
+        if (npcut == 0) {
             cout << "Optimal integer solution found:" << endl;
-        else {
+            if (objval < best - EPS) {
+                best = objval;
+                if (cb != NULL) cb(best, bound, cbdata);
+            }
+        } else {
             p.loadMat();                 /* Reload the problem */
             p.loadBasis(basis);          /* Load the saved basis */
             basis.reset();               /* No need to keep the basis any longer */
         }
     } while (npcut > 0);
+    if (deadline > 0) xbLimitLP(p.getXPRSprob(), &deadline, 0);
+
+    if (DETERMINISTIC && npass > 0 && T >= PARMINPERIODS) reportOverhead(&solprod[0], &solsetup[0]);
+
+    PLANPROD.resize(T);
+    PLANSETUP.resize(T);
+    if (npcut > 0 || p.getLPStat() != XPRB_LP_OPTIMAL) {
+        cout << "Cut loop stopped early, heuristic plan (cost " << best << ", bound " << bound << "):" << endl;
+        for (t = 0; t < T; t++) {
+            cout << "Period " << t + 1 << ": prod " << hprod[t] << " (demand: ";
+            cout << DEMAND[t] << ", cost: " << PRODCOST[t] << "), setup ";
+            cout << hsetup[t] << " (cost: " << SETUPCOST[t] << endl;
+            PLANPROD[t] = hprod[t];
+            PLANSETUP[t] = hsetup[t];
+        }
+        return best;
+    }
 
     /* Print out the solution: */
     for (t = 0; t < T; t++) {
         cout << "Period " << t + 1 << ": prod " << prod[t].getSol() << " (demand: ";
         cout << DEMAND[t] << ", cost: " << PRODCOST[t] << "), setup ";
         cout << setup[t].getSol() << " (cost: " << SETUPCOST[t] << endl;
+        PLANPROD[t] = prod[t].getSol();
+        PLANSETUP[t] = setup[t].getSol();
     }
+    return best;
+}
+
+double solveEls() {
+    return solveElsAnytime(0, NULL, NULL);
+}
+
+/**************************************************************************/
+/*  Parametric analysis: a plan is a sequence of production intervals,    */
+/*  production in s covers the demand of s..e. With F[s] the optimal      */
+/*  cost of periods 0..s-1 and B[e+1] that of periods e+1..T-1, the best  */
+/*  plan producing for s..e in s costs                                    */
+/*    G(s,e) = F[s] + SETUPCOST[s] + PRODCOST[s]*D[s][e] + B[e+1]         */
+/*  A change x of the setup cost in t adds x to all G(t,e), one of the    */
+/*  unit production cost adds x*D[t][e]; plans without a setup in t       */
+/*  (best value N[t]) are unaffected. The optimal cost as a function of   */
+/*  x is the lower envelope of these lines. With the LP relaxation        */
+/*  strengthened by all (l,S)-inequalities being integral, this is also   */
+/*  the parametric LP solution. Changes are valid down to a zero cost.    */
+/**************************************************************************/
+double costInterval(int s, int e) {
+    return SETUPCOST[s] + PRODCOST[s] * (double) D[s][e];
+}
+
+/* Lower envelope of the lines (slope, icpt); slopes must be given in
+   decreasing order */
+void lowerEnvelope(const vector<double> &slope, const vector<double> &icpt, ELSCurve *c) {
+    int k, n;
+
+    c->slope.clear();
+    c->icpt.clear();
+    c->bp.clear();
+    for (k = 0; k < (int) slope.size(); k++) {
+        n = (int) c->slope.size();
+        if (n > 0 && c->slope[n - 1] == slope[k]) {   /* Parallel: keep lower */
+            if (c->icpt[n - 1] <= icpt[k]) continue;
+            c->slope.pop_back();
+            c->icpt.pop_back();
+            if (n > 1) c->bp.pop_back();
+            n--;
+        }
+        /* Drop lines that are nowhere the lowest */
+        while (n > 1 && (icpt[k] - c->icpt[n - 1]) / (c->slope[n - 1] - slope[k]) <= c->bp[n - 2]) {
+            c->slope.pop_back();
+            c->icpt.pop_back();
+            c->bp.pop_back();
+            n--;
+        }
+        if (n > 0)
+            c->bp.push_back((icpt[k] - c->icpt[n - 1]) / (c->slope[n - 1] - slope[k]));
+        c->slope.push_back(slope[k]);
+        c->icpt.push_back(icpt[k]);
+    }
+}
+
+void parEls() {
+    int s, e, t;
+    double run;
+    vector<double> F(T + 1), B(T + 1), N(T), slope, icpt;
+
+    calcD();
+    CURVE[WI_SETUP].resize(T);
+    CURVE[WI_PROD].resize(T);
+
+    F[0] = 0;                             /* Forward: periods 0..e */
+    for (e = 0; e < T; e++) {
+        F[e + 1] = (DEMAND[e] == 0 ? F[e] : XPRB_INFINITY);
+        for (s = 0; s <= e; s++)
+            F[e + 1] = min(F[e + 1], F[s] + costInterval(s, e));
+    }
+    B[T] = 0;                             /* Backward: periods s..T-1 */
+    for (s = T - 1; s >= 0; s--) {
+        B[s] = (DEMAND[s] == 0 ? B[s + 1] : XPRB_INFINITY);
+        for (e = s; e < T; e++)
+            B[s] = min(B[s], costInterval(s, e) + B[e + 1]);
+    }
+
+    for (t = 0; t < T; t++)               /* Plans without a setup in t */
+        N[t] = (DEMAND[t] == 0 ? F[t] + B[t + 1] : XPRB_INFINITY);
+    for (s = 0; s < T; s++)
+        for (run = XPRB_INFINITY, e = T - 1; e > s; e--) {
+            run = min(run, F[s] + costInterval(s, e) + B[e + 1]);
+            N[e] = min(N[e], run);        /* Interval s..e' covers e */
+        }
+
+    for (t = 0; t < T; t++) {
+        slope.clear();                    /* Setup cost: one line per case */
+        icpt.clear();
+        for (run = XPRB_INFINITY, e = t; e < T; e++)
+            run = min(run, F[t] + costInterval(t, e) + B[e + 1]);
+        slope.push_back(1);
+        icpt.push_back(run);
+        if (N[t] < XPRB_INFINITY) {
+            slope.push_back(0);
+            icpt.push_back(N[t]);
+        }
+        lowerEnvelope(slope, icpt, &CURVE[WI_SETUP][t]);
+
+        slope.clear();                    /* Production cost: one line per e */
+        icpt.clear();
+        for (e = T - 1; e >= t; e--) {
+            slope.push_back(D[t][e]);
+            icpt.push_back(F[t] + costInterval(t, e) + B[e + 1]);
+        }
+        if (N[t] < XPRB_INFINITY) {
+            slope.push_back(0);
+            icpt.push_back(N[t]);
+        }
+        lowerEnvelope(slope, icpt, &CURVE[WI_PROD][t]);
+    }
+}
+
+/* Optimal cost after changing the cost of the given type in period t by
+   x; 'amount' returns the setup (0/1) or production in t */
+double whatIf(int type, int t, double x, double *amount) {
+    const ELSCurve *c = &CURVE[type][t];
+    int k;
+
+    k = (int) (upper_bound(c->bp.begin(), c->bp.end(), x) - c->bp.begin());
+    if (amount != NULL)
+        *amount = c->slope[k];           /* Setup (0/1) or production */
+    return c->icpt[k] + c->slope[k] * x;
+}
+
+void printCurves() {
+    int type, t, k;
+
+    for (type = 0; type < 2; type++)
+        for (t = 0; t < T; t++) {
+            const ELSCurve *c = &CURVE[type][t];
+            cout << (type == WI_SETUP ? "Setup" : "Production") << " cost period " << t + 1 << ": ";
+            for (k = 0; k < (int) c->slope.size(); k++) {
+                if (k > 0) cout << " | " << c->bp[k - 1] << " | ";
+                cout << c->icpt[k] << (c->slope[k] != 0 ? " + " : "");
+                if (c->slope[k] != 0) cout << c->slope[k] << "x";
+            }
+            cout << endl;
+        }
+}
+
+/* Answer a batch of what-if queries: lines 'setup t x' or 'prod t x' */
+int answerWhatIf(const char *fname) {
+    int t, type, n = 0;
+    double x, obj, amount;
+    char what[16];
+    ifstream in(fname);
+
+    while (in >> setw(16) >> what >> t >> x) {
+        type = (strcmp(what, "setup") == 0 ? WI_SETUP : WI_PROD);
+        if (t < 1 || t > T || (type == WI_PROD && strcmp(what, "prod") != 0)) {
+            cout << "Invalid query: " << what << " " << t << endl;
+            continue;
+        }
+        if (x < -(type == WI_SETUP ? SETUPCOST[t - 1] : PRODCOST[t - 1])) {
+            /* The curves do not hold below zero cost */
+            cout << "Query " << what << " " << t << " " << x << ": cost would be negative" << endl;
+            continue;
+        }
+        obj = whatIf(type, t - 1, x, &amount);
+        cout << "What if " << what << " cost " << t << " changes by " << x << ": cost " << obj;
+        if (type == WI_SETUP) cout << ", setup " << amount << endl;
+        else cout << ", production " << amount << endl;
+        n++;
+    }
+    return n;
+}
+
+/**************************************************************************/
+/*  Re-optimize the plan after each update of one period's demand or      */
+/*  cost read from 'fname' (lines 'demand t x', 'setup t x', 'prod t x')  */
+/**************************************************************************/
+int updateEls(const char *fname) {
+    int t, k, n = 0, starttime;
+    double obj;
+    vector<double> dem(T), sc(T), pc(T), solprod(T);
+    vector<int> solsetup(T);
+    char what[16];
+    WWDyn w;
+    ifstream in(fname);
+
+    for (t = 0; t < T; t++) {
+        dem[t] = DEMAND[t];
+        sc[t] = SETUPCOST[t];
+        pc[t] = PRODCOST[t];
+    }
+    obj = wwDynInit(&w, T, &dem[0], &sc[0], &pc[0], NULL);
+    cout << "Initial plan: cost " << obj << endl;
+
+    starttime = XPRB::getTime();
+    while (in >> setw(16) >> what >> k) {
+        if (k < 1 || k > T) {
+            cout << "Invalid period " << k << endl;
+            in >> obj;
+            continue;
+        }
+        k--;
+        if (!strcmp(what, "demand")) in >> dem[k];
+        else if (!strcmp(what, "setup")) in >> sc[k];
+        else if (!strcmp(what, "prod")) in >> pc[k];
+        else {
+            cout << "Invalid update: " << what << endl;
+            in >> obj;
+            continue;
+        }
+        obj = wwDynUpdate(&w, k, dem[k], sc[k], pc[k], 0);
+        wwDynPlan(&w, &solprod[0], &solsetup[0]);
+        cout << "Update " << ++n << " (" << what << " " << k + 1 << "): cost " << obj << ", setups";
+        for (t = 0; t < T; t++)
+            if (solsetup[t]) cout << " " << t + 1 << ":" << solprod[t];
+        cout << endl;
+    }
+    cout << n << " updates in " << (XPRB::getTime() - starttime) / 1000.0 << " sec" << endl;
+    return n;
+}
+
+/**************************************************************************/
+/*  Solution cache (see xbcache.h): the key is the series of demands,     */
+/*  setup and production costs with the optimizer controls sorted by      */
+/*  name, a solution the cost followed by the production and the setups   */
+/*  per period.                                                           */
+/**************************************************************************/
+void cacheKey(vector<double> *key) {
+    int k, t;
+    vector<int> prm(PARAMS.name.size());
+
+    for (k = 0; k < (int) prm.size(); k++) prm[k] = k;
+    sort(prm.begin(), prm.end(), [](int a, int b) { return PARAMS.name[a] < PARAMS.name[b]; });
+    key->assign(1, (double) prm.size());
+    for (k = 0; k < (int) prm.size(); k++) {
+        xbCacheKeyString(key, PARAMS.name[prm[k]]);
+        key->push_back(PARAMS.value[prm[k]]);
+    }
+    key->push_back(T);
+    for (t = 0; t < T; t++) {
+        key->push_back(DEMAND[t]);
+        key->push_back(SETUPCOST[t]);
+        key->push_back(PRODCOST[t]);
+    }
+}
+
+/*  Check a cached plan against the demands and its cost, and print it.   */
+/*  Return value: 0 if it fails                                           */
+int cacheCheck(const vector<double> &sol) {
+    int t;
+    double cum = 0, cost = 0;
+
+    if ((int) sol.size() != 1 + 2 * T) return 0;
+    for (t = 0; t < T; t++) {
+        cum += sol[1 + t];
+        if (cum < D[0][t] - EPS || sol[1 + t] > D[t][T - 1] * sol[1 + T + t] + EPS) return 0;
+        cost += PRODCOST[t] * sol[1 + t] + SETUPCOST[t] * sol[1 + T + t];
+    }
+    if (fabs(cost - sol[0]) > EPS * max(1.0, cost)) return 0;
+
+    cout << "Cached solution (cost " << sol[0] << "):" << endl;
+    for (t = 0; t < T; t++) {
+        cout << "Period " << t + 1 << ": prod " << sol[1 + t] << " (demand: ";
+        cout << DEMAND[t] << ", cost: " << PRODCOST[t] << "), setup ";
+        cout << sol[1 + T + t] << " (cost: " << SETUPCOST[t] << endl;
+    }
+    return 1;
 }
 
 /***********************************************************************/
 
 int main(int argc, char **argv) {
+    int i, t, starttime, maxtime = 0;
+    double cost;
+    const char *paramfile = "xbels.prm", *cachefile = NULL, *whatif = NULL, *dynamic = NULL;
+    vector<double> key, sol;
+    XBCache cache = {-1, NULL, NULL};
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 2 < argc) {
+            if (atoi(argv[i + 1]) < 1) {
+                cout << "Invalid number of periods " << argv[i + 1] << endl;
+                return 1;
+            }
+            genEls(atoi(argv[i + 1]), (unsigned) atoi(argv[i + 2]));
+            i += 2;
+        } else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-det"))
+            DETERMINISTIC = 1;
+        else if (!strcmp(argv[i], "-params") && i + 1 < argc)
+            paramfile = argv[++i];
+        else if (!strcmp(argv[i], "-cache") && i + 1 < argc)
+            cachefile = argv[++i];
+        else if (!strcmp(argv[i], "-whatif") && i + 1 < argc)
+            whatif = argv[++i];
+        else if (!strcmp(argv[i], "-dynamic") && i + 1 < argc)
+            dynamic = argv[++i];
+    }
+    if (whatif != NULL) {
+        parEls();
+        printCurves();
+        answerWhatIf(whatif);
+        return 0;
+    }
+    if (dynamic != NULL) {
+        updateEls(dynamic);
+        return 0;
+    }
+
+    if (xbReadParams(paramfile, &PARAMS) > 0)
+        cout << "Optimizer controls from " << paramfile << endl;
+    if (maxtime == 0 && cachefile != NULL && xbCacheOpen(&cache, cachefile)) {
+        calcD();
+        cacheKey(&key);
+        if (xbCacheLookup(&cache, key, &sol)) {
+            if (cacheCheck(sol)) {
+                xbCachePrintStats(&cache);
+                return XBCACHEHIT;
+            }
+            cout << "Cached solution fails the check, solving." << endl;
+            xbCacheDrop(&cache, key);
+        }
+    }
     modEls();                      /* Model the problem */
-    solveEls();                    /* Solve the problem */
+    if (maxtime > 0) {
+        starttime = XPRB::getTime();
+        solveElsAnytime(maxtime, xbPrintProgress, &starttime);
+    } else {
+        cost = solveEls();         /* Solve the problem */
+        if (cache.fd >= 0) {
+            sol.assign(1, cost);
+            for (t = 0; t < T; t++) sol.push_back(PLANPROD[t]);
+            for (t = 0; t < T; t++) sol.push_back(PLANSETUP[t]);
+            xbCacheStore(&cache, key, sol);
+            xbCachePrintStats(&cache);
+            xbCacheClose(&cache);
+        }
+    }
 
     return 0;
 } 
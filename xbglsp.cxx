@@ -0,0 +1,340 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbglsp.cxx
+  ```````````````
+  General lot sizing and scheduling problem (GLSP) with
+  sequence-dependent changeovers, on the data of the
+  capacitated lot sizing problem (xbcls.h).
+
+  Each macro-period t (capacity cap[t], demand per item)
+  is divided into S micro-periods. In every micro-period
+  s the line is set up for exactly one item (y[j][s]);
+  a change from item i to item j at the start of s
+  (z[i][j][s] >= y[i][s-1] + y[j][s] - 1) costs
+  CCOST[i][j] and takes CTIME[i][j] of the capacity of
+  the macro-period. The changeover matrices are derived
+  from the setup cost and time of the target item and
+  the distance between the items.
+
+  Solution approach:
+    relax-and-fix over the macro-periods for a start
+    fix-and-optimize: all windows of WINDOW consecutive
+      macro-periods are re-optimized with the sequence
+      outside the window fixed, in parallel threads each
+      with its own copy of the model; the best improving
+      window is accepted, until no window improves
+    MIP polish of the full model from the incumbent
+
+  Usage: xbglsp [datafile | -gen N T util seed] [-micro S]
+                [-maxtime sec] [-threads n]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbthreads.h"
+
+using namespace std;
+using namespace ::dashoptimization;
+
+#define EPS    1e-6
+
+#define WINDOW 2               /* Macro-periods per fix-and-optimize window */
+#define WINTIME 10             /* Time limit per window MIP (sec) */
+#define MAXROUNDS 100          /* Max. number of fix-and-optimize rounds */
+
+/****DATA****/
+CLSData DT;                             /* Items, demands and capacities */
+int S = 0;                              /* Micro-periods per macro-period */
+int NS;                                 /* Number of micro-periods: T*S */
+vector<double> CCOST;                   /* CCOST[i*N+j]: changeover cost */
+vector<double> CTIME;                   /* CTIME[i*N+j]: changeover time */
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+
+typedef struct {                        /* One copy of the GLSP model */
+    XPRBprob *prob;
+    vector<XPRBvar> x;                  /* x[j*NS+s]: production */
+    vector<XPRBvar> y;                  /* y[j*(NS+1)+s+1]: setup state, s=-1 initial */
+    vector<XPRBvar> z;                  /* z[(i*N+j)*NS+s]: changeover */
+    vector<XPRBvar> inv;                /* inv[j*T+t]: stock at the end of t */
+} GLSPModel;
+
+typedef struct {                        /* Setup sequence and its cost */
+    vector<int> y;
+    double cost;
+} GLSPSol;
+
+CLSStats stats;
+
+#define Y(j, s) ((j) * (NS + 1) + (s) + 1)
+
+/***********************************************************************/
+
+void genChangeovers() {
+    int i, j, N = DT.N;
+    double dist;
+
+    CCOST.assign(N * N, 0);
+    CTIME.assign(N * N, 0);
+    for (i = 0; i < N; i++)
+        for (j = 0; j < N; j++)
+            if (i != j) {
+                dist = fabs((double) (i - j)) / N;
+                CCOST[i * N + j] = DT.setupc[j] * (0.5 + dist);
+                CTIME[i * N + j] = DT.stime[j] * (0.5 + dist);
+            }
+}
+
+/**************************************************************************/
+/*  GLSP model builder                                                    */
+/**************************************************************************/
+void modGlsp(GLSPModel *m) {
+    int i, j, s, t, N = DT.N, T = DT.T;
+    XPRBprob &p = *m->prob;
+    XPRBexpr cobj, le;
+
+/****VARIABLES****/
+    m->x.resize(N * NS);
+    m->y.resize(N * (NS + 1));
+    m->z.resize(N * N * NS);
+    m->inv.resize(N * T);
+    for (j = 0; j < N; j++) {
+        for (s = -1; s < NS; s++)
+            m->y[Y(j, s)] = p.newVar(XPRBnewname("y%d_%d", j + 1, s + 1), XPRB_BV);
+        for (s = 0; s < NS; s++)
+            m->x[j * NS + s] = p.newVar(XPRBnewname("x%d_%d", j + 1, s + 1));
+        for (t = 0; t < T; t++)
+            m->inv[j * T + t] = p.newVar(XPRBnewname("inv%d_%d", j + 1, t + 1));
+    }
+    for (i = 0; i < N; i++)
+        for (j = 0; j < N; j++)
+            if (i != j)
+                for (s = 0; s < NS; s++)
+                    m->z[(i * N + j) * NS + s] = p.newVar(XPRBnewname("z%d_%d_%d", i + 1, j + 1, s + 1));
+
+/****OBJECTIVE****/
+    for (j = 0; j < N; j++)
+        for (t = 0; t < T; t++)
+            cobj += DT.holdc[j] * m->inv[j * T + t];
+    for (i = 0; i < N; i++)
+        for (j = 0; j < N; j++)
+            if (i != j)
+                for (s = 0; s < NS; s++)
+                    cobj += CCOST[i * N + j] * m->z[(i * N + j) * NS + s];
+    p.setObj(cobj);
+
+/****CONSTRAINTS****/
+    for (j = 0; j < N; j++)                       /* Stock balance */
+        for (t = 0; t < T; t++) {
+            le = m->inv[j * T + t] + DT.dem[j * T + t];
+            if (t > 0) le -= m->inv[j * T + t - 1];
+            for (s = t * S; s < (t + 1) * S; s++)
+                le -= m->x[j * NS + s];
+            p.newCtr("Balance", le == 0);
+        }
+
+    for (t = 0; t < T; t++) {                     /* Capacity incl. changeovers */
+        le = 0;
+        for (s = t * S; s < (t + 1) * S; s++)
+            for (j = 0; j < N; j++) {
+                le += DT.ptime[j] * m->x[j * NS + s];
+                for (i = 0; i < N; i++)
+                    if (i != j) le += CTIME[i * N + j] * m->z[(i * N + j) * NS + s];
+            }
+        p.newCtr("Capacity", le <= DT.cap[t]);
+    }
+
+    for (s = -1; s < NS; s++) {                   /* One setup state */
+        le = 0;
+        for (j = 0; j < N; j++)
+            le += m->y[Y(j, s)];
+        p.newCtr("State", le == 1);
+    }
+
+    for (j = 0; j < N; j++)
+        for (s = 0; s < NS; s++) {
+            /* Production only in the set up state */
+            p.newCtr("Produce", m->x[j * NS + s] <= DT.cap[s / S] / DT.ptime[j] * m->y[Y(j, s)]);
+            for (i = 0; i < N; i++)               /* Changeovers */
+                if (i != j)
+                    p.newCtr("Change", m->z[(i * N + j) * NS + s] >= m->y[Y(i, s - 1)] + m->y[Y(j, s)] - 1);
+        }
+}
+
+/*  Cost and setup sequence of the current MIP solution, 0 if there is none */
+int getSol(GLSPModel *m, GLSPSol *sol) {
+    int k;
+
+    if (m->prob->getMIPStat() != XPRB_MIP_OPTIMAL && m->prob->getMIPStat() != XPRB_MIP_SOLUTION)
+        return 0;
+    sol->cost = m->prob->getObjVal();
+    sol->y.resize(m->y.size());
+    for (k = 0; k < (int) m->y.size(); k++)
+        sol->y[k] = (m->y[k].getSol() > 0.5);
+    return 1;
+}
+
+/**************************************************************************/
+/*  Re-optimize macro-periods t1..t2-1 with the sequence elsewhere fixed   */
+/*  to 'inc' (which is passed as a start solution); maxtime 0: no limit   */
+/*  Return value: 1 if a solution was found                               */
+/**************************************************************************/
+int solveWindow(GLSPModel *m, const GLSPSol &inc, int t1, int t2, int maxtime, GLSPSol *sol) {
+    int j, s, s1, s2;
+    XPRBsol start;
+
+    s1 = (t1 == 0 ? -1 : t1 * S);                 /* Free micro-periods */
+    s2 = t2 * S;
+    start = m->prob->newSol();
+    for (j = 0; j < DT.N; j++)
+        for (s = -1; s < NS; s++) {
+            if (s >= s1 && s < s2) {
+                m->y[Y(j, s)].setLB(0);
+                m->y[Y(j, s)].setUB(1);
+            } else
+                m->y[Y(j, s)].fix(inc.y[Y(j, s)]);
+            start.setVar(m->y[Y(j, s)], inc.y[Y(j, s)]);
+        }
+    m->prob->addMIPSol(start);
+    XPRSsetintcontrol(m->prob->getXPRSprob(), XPRS_MAXTIME, maxtime > 0 ? -maxtime : 0);
+    m->prob->mipOptimize("");
+    return getSol(m, sol);
+}
+
+/**************************************************************************/
+/*  Relax-and-fix: the setup states of macro-period t are binary, those   */
+/*  of earlier ones fixed and those of later ones relaxed                 */
+/**************************************************************************/
+int relaxAndFix(GLSPModel *m, int maxtime, GLSPSol *sol) {
+    int j, s, t, T = DT.T;
+
+    for (j = 0; j < DT.N; j++)
+        for (s = -1; s < NS; s++)
+            m->y[Y(j, s)].setType(XPRB_PL);
+    if (maxtime > 0)
+        XPRSsetintcontrol(m->prob->getXPRSprob(), XPRS_MAXTIME, -max(1, maxtime / T));
+    for (t = 0; t < T; t++) {
+        for (j = 0; j < DT.N; j++)
+            for (s = (t == 0 ? -1 : t * S); s < (t + 1) * S; s++)
+                m->y[Y(j, s)].setType(XPRB_BV);
+        m->prob->mipOptimize("");
+        if (!getSol(m, sol)) return 0;
+        for (j = 0; j < DT.N; j++)
+            for (s = (t == 0 ? -1 : t * S); s < (t + 1) * S; s++)
+                m->y[Y(j, s)].fix(sol->y[Y(j, s)]);
+    }
+    return 1;
+}
+
+/**************************************************************************/
+/*  Fix-and-optimize over the windows, MIP polish                         */
+/**************************************************************************/
+void solveGlsp(int maxtime) {
+    int k, round, nwin, nthreads, best, T = DT.T;
+    double t0, start, left;
+    vector<GLSPModel> model;
+    vector<XPRBprob *> prob;
+    vector<GLSPSol> wsol;
+    vector<int> found;
+    GLSPSol inc;
+
+    start = clsClock();
+    nwin = max(1, T - WINDOW + 1);
+    nthreads = (NTHREADS > 0 ? NTHREADS : xbNumThreads());
+    nthreads = min(nthreads, nwin);
+
+    t0 = clsClock();                    /* One model per thread */
+    model.resize(nthreads);
+    for (k = 0; k < nthreads; k++) {
+        model[k].prob = new XPRBprob(XPRBnewname("Glsp%d", k + 1));
+        modGlsp(&model[k]);
+        XPRSsetintcontrol(model[k].prob->getXPRSprob(), XPRS_THREADS, 1);
+    }
+    clsRecord(&stats, "model build", clsClock() - t0, nthreads);
+
+    t0 = clsClock();
+    if (!relaxAndFix(&model[0], maxtime / 4, &inc)) {
+        cout << "Relax-and-fix found no solution." << endl;
+        for (k = 0; k < nthreads; k++)
+            delete model[k].prob;
+        return;
+    }
+    clsRecord(&stats, "relax-and-fix", clsClock() - t0, T);
+    cout << "Relax-and-fix: " << inc.cost << endl;
+    for (k = 0; k < (int) inc.y.size(); k++)       /* Restore binaries */
+        model[0].y[k].setType(XPRB_BV);
+
+    wsol.resize(nwin);
+    found.resize(nwin);
+    for (round = 1; round <= MAXROUNDS; round++) {
+        left = maxtime - (clsClock() - start);
+        if (maxtime > 0 && left < WINTIME) break;
+        t0 = clsClock();
+        /* Chunk c of the windows is solved on model c */
+        xbParallelChunks(nwin, (nwin + nthreads - 1) / nthreads, nthreads, [&](int lo, int hi, int c) {
+            for (int w = lo; w < hi; w++)
+                found[w] = solveWindow(&model[c], inc, w, min(T, w + WINDOW), WINTIME, &wsol[w]);
+        });
+        best = -1;                      /* Best improving window */
+        for (k = 0; k < nwin; k++)
+            if (found[k] && wsol[k].cost < inc.cost - EPS && (best < 0 || wsol[k].cost < wsol[best].cost))
+                best = k;
+        clsRecord(&stats, "fix-and-optimize", clsClock() - t0, nwin);
+        if (best < 0) break;
+        inc = wsol[best];
+        cout << "Round " << round << ": window " << best + 1 << ", cost " << inc.cost << endl;
+    }
+
+    t0 = clsClock();                    /* MIP polish */
+    left = maxtime - (clsClock() - start);
+    if (maxtime <= 0 || left >= 1) {
+        XPRSsetintcontrol(model[0].prob->getXPRSprob(), XPRS_THREADS,
+                          NTHREADS > 0 ? NTHREADS : -1);     /* -1: optimizer default */
+        if (solveWindow(&model[0], inc, 0, T, maxtime > 0 ? (int) left : 0, &wsol[0]) &&
+            wsol[0].cost < inc.cost - EPS)
+            inc = wsol[0];
+        clsRecord(&stats, "MIP polish", clsClock() - t0, 1);
+    }
+    cout << "Solution " << inc.cost << endl;
+
+    for (k = 0; k < nthreads; k++)
+        delete model[k].prob;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, maxtime = 300;
+
+    clsGenerate(&DT, 10, 8, 0.7, 1);
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-micro") && i + 1 < argc)
+            S = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    if (S <= 0) S = DT.N;              /* Room for every item in each period */
+    NS = DT.T * S;
+    genChangeovers();
+
+    solveGlsp(maxtime);
+    clsPrintStats(&stats);
+
+    return 0;
+}
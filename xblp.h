@@ -0,0 +1,295 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xblp.h
+  ```````````
+  Embedded bounded dual simplex for small LPs, e.g. the
+  master problems of column generation with a few dozen
+  rows, where loading the matrix into the optimizer
+  costs more than the pivoting.
+
+    min c x  s.t.  rlo <= A x <= rhi,  lb <= x <= ub
+
+  Every row i has a logical variable r[i] = a[i] x with
+  the row bounds, so that A x - r = 0; the logicals are
+  variables 0..m-1, the columns follow. The basis
+  inverse is kept dense (m x m) and updated by the
+  pivots, and recomputed every XBLP_REFACTOR iterations.
+
+  A nonbasic variable sits at the bound that makes its
+  reduced cost dual feasible (lower bound for d >= 0,
+  upper bound for d < 0), so the slack basis of a
+  problem with c >= 0 and the basis of the last solve
+  after adding columns with finite upper bounds are
+  dual feasible: the dual simplex starts there and only
+  repairs the primal infeasibilities. A new column with
+  negative reduced cost and no upper bound cannot be
+  placed, and xbLpSolve returns XBLP_DUALINFEAS; the
+  caller then solves with the optimizer. Lower bounds
+  must be finite.
+********************************************************/
+
+#ifndef XBLP_H
+#define XBLP_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#define XBLP_INF 1e20           /* Infinite bound */
+#define XBLP_FEASTOL 1e-7       /* Primal feasibility tolerance */
+#define XBLP_OPTTOL 1e-9        /* Dual feasibility tolerance */
+#define XBLP_PIVTOL 1e-9        /* Smallest pivot element */
+#define XBLP_REFACTOR 50        /* Iterations between recomputing the inverse */
+
+#define XBLP_OPTIMAL 0
+#define XBLP_INFEASIBLE 1
+#define XBLP_DUALINFEAS 2       /* Starting basis not dual feasible */
+#define XBLP_ITERLIMIT 3
+#define XBLP_SINGULAR 4
+
+#define XBLP_BASIC 0
+#define XBLP_ATLB 1
+#define XBLP_ATUB 2
+
+typedef struct {
+    int m, n;                           /* Rows, columns */
+    std::vector<double> a;              /* Column j: a[j*m .. j*m+m-1] */
+    std::vector<double> c, lb, ub;      /* Per variable: m logicals, n columns */
+    std::vector<int> stat;              /* XBLP_BASIC, _ATLB or _ATUB */
+    std::vector<int> head;              /* Basic variable of each row */
+    std::vector<double> binv;           /* Basis inverse, row-major */
+    std::vector<double> x, d;           /* Values, reduced costs */
+    std::vector<double> y;              /* Row duals */
+    double obj;
+    int iter;                           /* Iterations of the last solve */
+    long itertot;                       /* ... and of all solves */
+} XBLp;
+
+/* v . (column of variable k) */
+static inline double xbLpDot(const XBLp *lp, int k, const double *v) {
+    int i;
+    double s = 0;
+    const double *col;
+
+    if (k < lp->m) return -v[k];
+    col = &lp->a[(size_t) (k - lp->m) * lp->m];
+    for (i = 0; i < lp->m; i++) s += v[i] * col[i];
+    return s;
+}
+
+/* w = B^-1 (column of variable k) */
+static inline void xbLpFtran(const XBLp *lp, int k, double *w) {
+    int i, l, m = lp->m;
+    const double *col;
+
+    for (i = 0; i < m; i++) {
+        if (k < m)
+            w[i] = -lp->binv[(size_t) i * m + k];
+        else {
+            col = &lp->a[(size_t) (k - m) * m];
+            for (w[i] = 0, l = 0; l < m; l++) w[i] += lp->binv[(size_t) i * m + l] * col[l];
+        }
+    }
+}
+
+/* Empty problem of m rows with the bounds rlo/rhi; slack basis */
+static inline void xbLpInit(XBLp *lp, int m, const double *rlo, const double *rhi) {
+    int i;
+
+    lp->m = m;
+    lp->n = 0;
+    lp->a.clear();
+    lp->c.assign(m, 0.0);
+    lp->lb.assign(rlo, rlo + m);
+    lp->ub.assign(rhi, rhi + m);
+    lp->stat.assign(m, XBLP_BASIC);
+    lp->head.resize(m);
+    lp->binv.assign((size_t) m * m, 0.0);
+    for (i = 0; i < m; i++) {
+        lp->head[i] = i;
+        lp->binv[(size_t) i * m + i] = -1;
+    }
+    lp->x.assign(m, 0.0);
+    lp->d.assign(m, 0.0);
+    lp->y.assign(m, 0.0);
+    lp->obj = 0;
+    lp->iter = 0;
+    lp->itertot = 0;
+}
+
+/**************************************************************************/
+/* Add a column (dense, m coefficients). It becomes nonbasic at the bound */
+/* that is dual feasible for the duals of the last solve, which keeps the */
+/* basis for the warm start.                                              */
+/**************************************************************************/
+static inline void xbLpAddCol(XBLp *lp, double c, const double *col, double lb, double ub) {
+    double d;
+
+    lp->a.insert(lp->a.end(), col, col + lp->m);
+    lp->c.push_back(c);
+    lp->lb.push_back(lb);
+    lp->ub.push_back(ub);
+    lp->n++;
+    d = c - xbLpDot(lp, lp->m + lp->n - 1, &lp->y[0]);
+    lp->stat.push_back(d < 0 && ub < XBLP_INF ? XBLP_ATUB : XBLP_ATLB);
+    lp->x.push_back(lp->stat.back() == XBLP_ATUB ? ub : lb);
+    lp->d.push_back(d);
+}
+
+/* Recompute the basis inverse (Gauss-Jordan with partial pivoting) */
+static inline int xbLpInvert(XBLp *lp) {
+    int i, k, l, r, m = lp->m;
+    double f, *rowr, *rowi;
+    std::vector<double> B((size_t) m * m, 0.0);
+
+    for (k = 0; k < m; k++) {                   /* B[i][k]: row i of column head[k] */
+        if (lp->head[k] < m)
+            B[(size_t) lp->head[k] * m + k] = -1;
+        else
+            for (i = 0; i < m; i++) B[(size_t) i * m + k] = lp->a[(size_t) (lp->head[k] - m) * m + i];
+    }
+    lp->binv.assign((size_t) m * m, 0.0);
+    for (i = 0; i < m; i++) lp->binv[(size_t) i * m + i] = 1;
+    for (k = 0; k < m; k++) {
+        for (r = k, i = k + 1; i < m; i++)
+            if (fabs(B[(size_t) i * m + k]) > fabs(B[(size_t) r * m + k])) r = i;
+        if (fabs(B[(size_t) r * m + k]) < XBLP_PIVTOL) return 0;
+        for (l = 0; l < m; l++) {
+            std::swap(B[(size_t) r * m + l], B[(size_t) k * m + l]);
+            std::swap(lp->binv[(size_t) r * m + l], lp->binv[(size_t) k * m + l]);
+        }
+        rowr = &B[(size_t) k * m];
+        f = 1 / rowr[k];
+        for (l = 0; l < m; l++) {
+            rowr[l] *= f;
+            lp->binv[(size_t) k * m + l] *= f;
+        }
+        for (i = 0; i < m; i++) {
+            if (i == k || (f = B[(size_t) i * m + k]) == 0) continue;
+            rowi = &B[(size_t) i * m];
+            for (l = 0; l < m; l++) {
+                rowi[l] -= f * rowr[l];
+                lp->binv[(size_t) i * m + l] -= f * lp->binv[(size_t) k * m + l];
+            }
+        }
+    }
+    return 1;
+}
+
+/* Values of the basic variables, duals and reduced costs for the basis */
+static inline void xbLpCompute(XBLp *lp) {
+    int i, k, l, m = lp->m, nv = lp->m + lp->n;
+    std::vector<double> rhs(m, 0.0), cb(m);
+
+    for (k = 0; k < nv; k++) {                  /* rhs = -N xN */
+        if (lp->stat[k] == XBLP_BASIC) continue;
+        lp->x[k] = (lp->stat[k] == XBLP_ATUB ? lp->ub[k] : lp->lb[k]);
+        if (lp->x[k] == 0) continue;
+        if (k < m)
+            rhs[k] += lp->x[k];
+        else
+            for (i = 0; i < m; i++) rhs[i] -= lp->a[(size_t) (k - m) * m + i] * lp->x[k];
+    }
+    for (i = 0; i < m; i++) {
+        lp->x[lp->head[i]] = 0;
+        for (l = 0; l < m; l++) lp->x[lp->head[i]] += lp->binv[(size_t) i * m + l] * rhs[l];
+        cb[i] = lp->c[lp->head[i]];
+    }
+    for (l = 0; l < m; l++)                     /* y = cB B^-1 */
+        for (lp->y[l] = 0, i = 0; i < m; i++) lp->y[l] += cb[i] * lp->binv[(size_t) i * m + l];
+    for (k = 0; k < nv; k++)
+        lp->d[k] = (lp->stat[k] == XBLP_BASIC ? 0 : lp->c[k] - xbLpDot(lp, k, &lp->y[0]));
+}
+
+/**************************************************************************/
+/* Dual simplex from the current basis, at most maxiter iterations.       */
+/* Return value: XBLP_OPTIMAL, ... (see above)                            */
+/**************************************************************************/
+static inline int xbLpSolve(XBLp *lp, int maxiter) {
+    int i, k, l, r, q, flip, m = lp->m, nv = lp->m + lp->n;
+    double viol, v, alpha, ratio, best, bestalpha, f;
+    std::vector<double> w(m);
+    const double *rho;
+
+    lp->iter = 0;
+    for (;;) {
+        if (lp->iter > 0 && lp->iter % XBLP_REFACTOR == 0 && !xbLpInvert(lp)) return XBLP_SINGULAR;
+        xbLpCompute(lp);
+
+        for (flip = 0, k = 0; k < nv; k++) {    /* Keep the nonbasics dual feasible */
+            if (lp->stat[k] == XBLP_ATLB && lp->d[k] < -XBLP_OPTTOL) {
+                if (lp->ub[k] >= XBLP_INF) return XBLP_DUALINFEAS;
+                lp->stat[k] = XBLP_ATUB;
+                flip = 1;
+            } else if (lp->stat[k] == XBLP_ATUB && lp->d[k] > XBLP_OPTTOL) {
+                lp->stat[k] = XBLP_ATLB;
+                flip = 1;
+            }
+        }
+        if (flip) xbLpCompute(lp);
+
+        for (r = -1, viol = XBLP_FEASTOL, i = 0; i < m; i++) {  /* Leaving row */
+            k = lp->head[i];
+            v = std::max(lp->lb[k] - lp->x[k], lp->x[k] - lp->ub[k]);
+            if (v > viol) {
+                viol = v;
+                r = i;
+            }
+        }
+        if (r < 0) break;                       /* Primal feasible: optimal */
+        if (lp->iter >= maxiter) return XBLP_ITERLIMIT;
+
+        /* Entering variable: ratio test on row r of B^-1 N. For a leaving
+           variable below its lower bound, x[head[r]] grows with a nonbasic
+           at its lower bound and alpha < 0 or at its upper bound and alpha > 0 */
+        rho = &lp->binv[(size_t) r * m];
+        f = (lp->x[lp->head[r]] < lp->lb[lp->head[r]] ? 1 : -1);
+        for (q = -1, best = XBLP_INF, bestalpha = 0, k = 0; k < nv; k++) {
+            if (lp->stat[k] == XBLP_BASIC || lp->lb[k] == lp->ub[k]) continue;
+            alpha = f * xbLpDot(lp, k, rho);
+            if (lp->stat[k] == XBLP_ATLB ? alpha > -XBLP_PIVTOL : alpha < XBLP_PIVTOL) continue;
+            ratio = fabs(lp->d[k]) / fabs(alpha);
+            if (ratio < best - XBLP_OPTTOL || (ratio < best + XBLP_OPTTOL && fabs(alpha) > bestalpha)) {
+                best = ratio;
+                bestalpha = fabs(alpha);
+                q = k;
+            }
+        }
+        if (q < 0) return XBLP_INFEASIBLE;      /* Dual unbounded */
+
+        xbLpFtran(lp, q, &w[0]);                /* Pivot */
+        if (fabs(w[r]) < XBLP_PIVTOL) {
+            if (!xbLpInvert(lp)) return XBLP_SINGULAR;
+            lp->iter++;
+            continue;
+        }
+        k = lp->head[r];
+        lp->stat[k] = (lp->x[k] < lp->lb[k] ? XBLP_ATLB : XBLP_ATUB);
+        lp->head[r] = q;
+        lp->stat[q] = XBLP_BASIC;
+        f = 1 / w[r];
+        for (l = 0; l < m; l++) lp->binv[(size_t) r * m + l] *= f;
+        for (i = 0; i < m; i++)
+            if (i != r && w[i] != 0)
+                for (l = 0; l < m; l++) lp->binv[(size_t) i * m + l] -= w[i] * lp->binv[(size_t) r * m + l];
+        lp->iter++;
+        lp->itertot++;
+    }
+
+    for (lp->obj = 0, k = 0; k < nv; k++) lp->obj += lp->c[k] * lp->x[k];
+    return XBLP_OPTIMAL;
+}
+
+/* Value of column j */
+static inline double xbLpSol(const XBLp *lp, int j) {
+    return lp->x[lp->m + j];
+}
+
+/* Dual of row i; >= 0 for a row at its lower bound in a minimization */
+static inline double xbLpDual(const XBLp *lp, int i) {
+    return lp->y[i];
+}
+
+#endif
@@ -0,0 +1,126 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbnuma.h
+  `````````````
+  NUMA placement for the batch and simulation modes:
+  the nodes (sockets) and their cores are read from
+  /sys/devices/system/node; without it (or on other
+  systems) all cores form one node.
+
+  A thread pinned to the cores of a node with
+  xbNumaPin() gets its memory from that node when it
+  touches the memory first, which is Linux's default
+  policy. So a worker pins itself before it allocates
+  and fills its model, DP tables or scenario buffers,
+  and data read by all workers of a node is copied once
+  per node by a pinned task (xbNumaReplicate). A
+  process started by a pinned thread inherits the
+  pinning.
+********************************************************/
+
+#ifndef XBNUMA_H
+#define XBNUMA_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <functional>
+#include "xbthreads.h"
+#include <sched.h>
+
+typedef struct {
+    std::vector<std::vector<int> > cpus;    /* Cores per node */
+} XBNuma;
+
+/* Parse a sysfs cpu list such as '0-7,16-23' */
+static inline void xbNumaParseList(const std::string &s, std::vector<int> *cpus) {
+    int a, b;
+    char c;
+    std::string item;
+    std::istringstream ls(s);
+
+    while (std::getline(ls, item, ',')) {
+        std::istringstream is(item);
+        if (!(is >> a)) continue;
+        b = a;
+        if (is >> c && c == '-') is >> b;
+        for (; a <= b; a++) cpus->push_back(a);
+    }
+}
+
+/**************************************************************************/
+/* Read the node topology; only cores the process may run on are kept.    */
+/* Return value: number of nodes                                          */
+/**************************************************************************/
+static inline int xbNumaInit(XBNuma *nm) {
+    int n, k;
+    std::string line;
+    std::vector<int> cpus, mine;
+    cpu_set_t set;
+
+    nm->cpus.clear();
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        for (k = 0; k < (int) std::thread::hardware_concurrency(); k++) CPU_SET(k, &set);
+    for (n = 0;; n++) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        if (!in || !std::getline(in, line)) break;
+        cpus.clear();
+        mine.clear();
+        xbNumaParseList(line, &cpus);
+        for (k = 0; k < (int) cpus.size(); k++)
+            if (cpus[k] < CPU_SETSIZE && CPU_ISSET(cpus[k], &set)) mine.push_back(cpus[k]);
+        if (!mine.empty()) nm->cpus.push_back(mine);
+    }
+    if (nm->cpus.empty()) {                     /* One node of all cores */
+        nm->cpus.resize(1);
+        for (k = 0; k < CPU_SETSIZE; k++)
+            if (CPU_ISSET(k, &set)) nm->cpus[0].push_back(k);
+    }
+    return (int) nm->cpus.size();
+}
+
+static inline int xbNumaNodes(const XBNuma *nm) {
+    return (int) nm->cpus.size();
+}
+
+/* Pin the calling thread to the cores of node; the old pinning goes to saved */
+static inline int xbNumaPin(const XBNuma *nm, int node, cpu_set_t *saved) {
+    size_t k;
+    cpu_set_t set;
+
+    if (saved != NULL) sched_getaffinity(0, sizeof(*saved), saved);
+    CPU_ZERO(&set);
+    for (k = 0; k < nm->cpus[node].size(); k++) CPU_SET(nm->cpus[node][k], &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+static inline void xbNumaRestore(const cpu_set_t *saved) {
+    sched_setaffinity(0, sizeof(*saved), saved);
+}
+
+/* Node of the k-th of n workers: contiguous blocks, so neighbours share a node */
+static inline int xbNumaNodeOf(const XBNuma *nm, int k, int n) {
+    return (int) ((long) k * xbNumaNodes(nm) / (n > 0 ? n : 1));
+}
+
+/**************************************************************************/
+/* Run copy(node) for each node as a task pinned to that node, so that   */
+/* what it allocates and fills is local to the node (e.g. per-node        */
+/* replicas of shared read-only data).                                    */
+/**************************************************************************/
+static inline void xbNumaReplicate(const XBNuma *nm, const std::function<void(int)> &copy) {
+    xbParallelChunks(xbNumaNodes(nm), 1, xbNumaNodes(nm), [nm, &copy](int lo, int hi, int n) {
+        cpu_set_t saved;
+
+        xbNumaPin(nm, n, &saved);
+        copy(n);
+        xbNumaRestore(&saved);
+    });
+}
+
+#endif
@@ -0,0 +1,115 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbparams.h
+  ```````````````
+  Optimizer control settings per model family, as
+  written by the tuner (xbtune.cxx) and loaded by the
+  solvers at startup. A parameter file has one control
+  per line, 'NAME value' with the name of the control
+  without the XPRS_ prefix; '#' starts a comment:
+
+    # xbtune: family cutstk
+    CUTSTRATEGY 0
+    PREPROBING 1
+
+  The solvers look for FAMILY.prm in the current
+  directory (e.g. xbcutstk.prm) unless a file is given
+  with -params.
+
+  xbApplyParams() maps the names to the controls of
+  the optimizer; it is available when xprs.h has been
+  included before this file, so that the tuner, which
+  only runs the solvers, does not need the optimizer.
+********************************************************/
+
+#ifndef XBPARAMS_H
+#define XBPARAMS_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef struct {
+    std::vector<std::string> name;      /* Control names without XPRS_ */
+    std::vector<double> value;
+} XBParams;
+
+/* Set control name to value, replacing an earlier setting */
+static inline void xbSetParam(XBParams *pr, const std::string &name, double value) {
+    size_t k;
+
+    for (k = 0; k < pr->name.size() && pr->name[k] != name; k++);
+    if (k == pr->name.size()) {
+        pr->name.push_back(name);
+        pr->value.push_back(value);
+    } else
+        pr->value[k] = value;
+}
+
+/**************************************************************************/
+/* Read a parameter file; a missing file leaves pr unchanged.             */
+/* Return value: number of controls read, -1 if the file does not exist   */
+/**************************************************************************/
+static inline int xbReadParams(const char *fname, XBParams *pr) {
+    int n = 0;
+    double value;
+    std::string line, name;
+    std::ifstream in(fname);
+
+    if (!in) return -1;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+        if (!(ls >> name)) continue;
+        if (!(ls >> value)) {
+            std::cout << fname << ": no value for " << name << std::endl;
+            continue;
+        }
+        xbSetParam(pr, name, value);
+        n++;
+    }
+    return n;
+}
+
+static inline int xbWriteParams(const char *fname, const XBParams *pr, const char *header) {
+    size_t k;
+    std::ofstream out(fname);
+
+    if (!out) return 0;
+    if (header != NULL) out << "# " << header << std::endl;
+    for (k = 0; k < pr->name.size(); k++)
+        out << pr->name[k] << " " << pr->value[k] << std::endl;
+    return 1;
+}
+
+#ifdef XPRS_CC
+/**************************************************************************/
+/* Set the controls of pr on the optimizer problem xprob.                 */
+/* Return value: number of controls set                                   */
+/**************************************************************************/
+static inline int xbApplyParams(XPRSprob xprob, const XBParams *pr) {
+    size_t k;
+    int id, type, n = 0;
+
+    for (k = 0; k < pr->name.size(); k++) {
+        if (XPRSgetcontrolinfo(xprob, pr->name[k].c_str(), &id, &type) || id == 0) {
+            std::cout << "Unknown control " << pr->name[k] << std::endl;
+            continue;
+        }
+        if (type == XPRS_TYPE_INT || type == XPRS_TYPE_INT64)
+            XPRSsetintcontrol(xprob, id, (int) pr->value[k]);
+        else if (type == XPRS_TYPE_DOUBLE)
+            XPRSsetdblcontrol(xprob, id, pr->value[k]);
+        else
+            continue;
+        n++;
+    }
+    return n;
+}
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbpmls.cxx
+  ```````````````
+  Lot sizing on parallel machines with machine
+  assignment. The items of the capacitated lot sizing
+  data (xbcls.h) are produced on M parallel lines that
+  differ in capacity, speed, setup and production cost.
+  Every item is assigned to one machine.
+
+  Compact model (-compact):
+    sum(m) z[m][i] = 1
+    s[m][i][t-1] + x[m][i][t] = DEM[i][t]*z[m][i] + s[m][i][t]
+    x[m][i][t] <= D[i][t][T]*y[m][i][t],  y[m][i][t] <= z[m][i]
+    sum(i) ptime*x[m][i][t] + stime*y[m][i][t] <= cap[m][t]
+
+  Dantzig-Wolfe decomposition (default): a column is the
+  production plan of item i on machine m. The master
+  keeps the assignment rows (duals alpha[i]) and the
+  machine capacities (duals pi[m][t] <= 0). Pricing for
+  machine m is one Wagner-Whitin DP per item with setup
+  cost setupc - pi*stime and unit cost prodc - pi*ptime;
+  the machines are priced concurrently (see xbdw.h). The
+  final plans come from the master MIP over the
+  generated columns.
+
+  Usage: xbpmls [datafile | -gen N T util seed] [-machines M]
+                [-compact] [-maxtime sec] [-threads n]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbww.h"
+#include "xbthreads.h"
+#include "xbdw.h"
+
+using namespace std;
+using namespace ::dashoptimization;
+
+
+
+/****DATA****/
+CLSData DT;                             /* Item data and base capacity */
+int M = 3;                              /* Number of machines */
+vector<double> MCAP;                    /* MCAP[m]: share of base capacity */
+vector<double> MSPEED;                  /* MSPEED[m]: factor on ptime */
+vector<double> MSETUP;                  /* MSETUP[m]: factor on setup cost */
+vector<double> MPROD;                   /* MPROD[m]: unit production cost */
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+
+DWMaster DW;                            /* Plans of the items on the machines */
+XPRBprob p("PMLs");                     /* Initialize a new problem in BCL */
+
+CLSStats stats;
+
+/***********************************************************************/
+
+void genMachines(unsigned seed) {
+    int m;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+
+    MCAP.resize(M);
+    MSPEED.resize(M);
+    MSETUP.resize(M);
+    MPROD.resize(M);
+    for (m = 0; m < M; m++) {
+        MSPEED[m] = floor(80 + 40 * U(rng)) / 100;
+        MCAP[m] = 1.2 * MSPEED[m] / M;          /* Some slack over the base */
+        MSETUP[m] = floor(80 + 40 * U(rng)) / 100;
+        MPROD[m] = floor(1 + 3 * U(rng));
+    }
+}
+
+double mCap(int m, int t) { return floor(DT.cap[t] * MCAP[m]); }
+
+double mPtime(int m, int i) { return DT.ptime[i] * MSPEED[m]; }
+
+/**************************************************************************/
+/*  Best plan of item i on machine m under the capacity duals pi[m][t]    */
+/*  (NULL for none). Return value: cost of the plan under the duals       */
+/**************************************************************************/
+double priceItem(int m, int i, const double *pi, DWCol *col) {
+    int t, T = DT.T;
+    double z, stock = 0;
+    vector<double> setupc(T), prodc(T), holdc(T, DT.holdc[i]);
+
+    for (t = 0; t < T; t++) {
+        setupc[t] = MSETUP[m] * DT.setupc[i] - (pi != NULL ? pi[m * T + t] * DT.stime[i] : 0);
+        prodc[t] = MPROD[m] - (pi != NULL ? pi[m * T + t] * mPtime(m, i) : 0);
+    }
+    col->b = m;
+    col->i = i;
+    col->row0 = m * T;                  /* Capacity rows of machine m */
+    col->prod.resize(T);
+    col->setup.resize(T);
+    z = wwSolve(T, &DT.dem[i * T], &setupc[0], &prodc[0], &holdc[0], &col->prod[0], &col->setup[0]);
+
+    col->use.resize(T);
+    col->cost = 0;
+    for (t = 0; t < T; t++) {
+        stock += col->prod[t] - DT.dem[i * T + t];
+        col->use[t] = mPtime(m, i) * col->prod[t] + DT.stime[i] * col->setup[t];
+        col->cost += MSETUP[m] * DT.setupc[i] * col->setup[t] + MPROD[m] * col->prod[t] +
+                     DT.holdc[i] * stock;
+    }
+    return z;
+}
+
+/**************************************************************************/
+/*  Column generation over the plans of the items on the machines (the    */
+/*  blocks of xbdw.h); the artificial columns cost leaving an item        */
+/*  unassigned. Return value: Lagrangian lower bound                      */
+/**************************************************************************/
+double solveDW(int maxtime) {
+    int i, m, t, T = DT.T;
+    double lb;
+    vector<double> cap(M * T);
+
+    for (m = 0; m < M; m++)
+        for (t = 0; t < T; t++) cap[m * T + t] = mCap(m, t);
+    dwInit(&DW, &p, DT.N, M, cap);
+    DW.nthreads = NTHREADS;
+    DW.grain = DT.N;                    /* One chunk per machine */
+    lb = dwSolve(&DW, priceItem, maxtime, &stats);
+
+    if (p.getMIPStat() == XPRB_MIP_OPTIMAL || p.getMIPStat() == XPRB_MIP_SOLUTION) {
+        cout << "Solution " << p.getObjVal() << ", bound " << lb << endl;
+        for (i = 0; i < (int) DW.cols.size(); i++)
+            if (DW.cols[i].lam.getSol() > 0.5) {
+                cout << "   item " << DW.cols[i].i + 1 << " on machine " << DW.cols[i].b + 1 << ": setups";
+                for (t = 0; t < T; t++)
+                    if (DW.cols[i].setup[t]) cout << " " << t + 1;
+                cout << ", cost " << DW.cols[i].cost << endl;
+            }
+    } else
+        cout << "No assignment found among the generated plans." << endl;
+    return lb;
+}
+
+/**************************************************************************/
+/*  Compact parallel machine model, solved as a MIP                       */
+/**************************************************************************/
+void solveCompact(int maxtime) {
+    int i, m, t, T = DT.T, N = DT.N;
+    double t0;
+    vector<XPRBvar> x(M * N * T), s(M * N * T), y(M * N * T), z(M * N);
+    XPRBexpr cost, le;
+    XPRBprob pc("PMLsCompact");
+
+#define MIT(m, i, t) (((m) * N + (i)) * T + (t))
+    t0 = clsClock();
+    for (m = 0; m < M; m++)
+        for (i = 0; i < N; i++) {
+            z[m * N + i] = pc.newVar(XPRBnewname("z%d_%d", m + 1, i + 1), XPRB_BV);
+            for (t = 0; t < T; t++) {
+                x[MIT(m, i, t)] = pc.newVar(XPRBnewname("x%d_%d_%d", m + 1, i + 1, t + 1));
+                s[MIT(m, i, t)] = pc.newVar(XPRBnewname("s%d_%d_%d", m + 1, i + 1, t + 1));
+                y[MIT(m, i, t)] = pc.newVar(XPRBnewname("y%d_%d_%d", m + 1, i + 1, t + 1), XPRB_BV);
+                cost += MSETUP[m] * DT.setupc[i] * y[MIT(m, i, t)] + MPROD[m] * x[MIT(m, i, t)] +
+                        DT.holdc[i] * s[MIT(m, i, t)];
+            }
+        }
+    pc.setObj(cost);
+
+    for (i = 0; i < N; i++) {
+        le = 0;
+        for (m = 0; m < M; m++) le += z[m * N + i];
+        pc.newCtr("Assign", le == 1);
+    }
+    for (m = 0; m < M; m++)
+        for (i = 0; i < N; i++)
+            for (t = 0; t < T; t++) {
+                if (t > 0)
+                    pc.newCtr("Balance", s[MIT(m, i, t - 1)] + x[MIT(m, i, t)] ==
+                              DT.dem[i * T + t] * z[m * N + i] + s[MIT(m, i, t)]);
+                else
+                    pc.newCtr("Balance", x[MIT(m, i, t)] == DT.dem[i * T + t] * z[m * N + i] + s[MIT(m, i, t)]);
+                pc.newCtr("Produce", x[MIT(m, i, t)] <= clsDem(&DT, i, t, T - 1) * y[MIT(m, i, t)]);
+                pc.newCtr("Assigned", y[MIT(m, i, t)] <= z[m * N + i]);
+            }
+    for (m = 0; m < M; m++)
+        for (t = 0; t < T; t++) {
+            le = 0;
+            for (i = 0; i < N; i++)
+                le += mPtime(m, i) * x[MIT(m, i, t)] + DT.stime[i] * y[MIT(m, i, t)];
+            pc.newCtr("Capacity", le <= mCap(m, t));
+        }
+#undef MIT
+
+    if (maxtime > 0)
+        XPRSsetintcontrol(pc.getXPRSprob(), XPRS_MAXTIME, -maxtime);
+    pc.mipOptimize("");
+    clsRecord(&stats, "compact MIP", clsClock() - t0, 1);
+    if (pc.getMIPStat() == XPRB_MIP_OPTIMAL || pc.getMIPStat() == XPRB_MIP_SOLUTION)
+        cout << "Compact model: solution " << pc.getObjVal() << endl;
+    else
+        cout << "Compact model: no solution found." << endl;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, compact = 0, maxtime = 0;
+
+    clsGenerate(&DT, 20, 12, 0.8, 1);
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-machines") && i + 1 < argc)
+            M = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-compact"))
+            compact = 1;
+        else if (!strcmp(argv[i], "-maxtime") && i + 1 < argc)
+            maxtime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    genMachines(1);
+
+    if (compact)
+        solveCompact(maxtime);
+    else
+        solveDW(maxtime);
+    clsPrintStats(&stats);
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbrobust.h
+  ```````````````
+  Robust uncapacitated lot sizing under budgeted demand
+  uncertainty (Bertsimas and Thiele, 2006): the demand
+  of period t lies in [dem[t]-dev[t], dem[t]+dev[t]] and
+  up to gamma[t] of the periods 0..t deviate from their
+  nominal demand. With the protection level
+    A[t] = max{ sum(u<=t) dev[u]*z[u] :
+                sum(u<=t) z[u] <= gamma[t], 0 <= z <= 1 }
+  the worst-case cost of the stock at the end of t for
+  the cumulative production P[t] and the nominal
+  cumulative demand Dc[t] is
+    c[t](P) = max{ holdc*(P - Dc[t] + A[t]),
+                   shortc*(Dc[t] + A[t] - P) }
+  a convex function with its minimum at
+    m[t] = Dc[t] + A[t]*(shortc-holdc)/(shortc+holdc)
+
+  The robust problem minimizes the setup cost plus the
+  sum of c[t](P[t]) over nondecreasing P. Between two
+  setups P is constant, and a sum of the c[t] under the
+  order constraint has an optimum with every level in
+  the set L of the points m[t] and 0. The dynamic
+  program over (setup period, level)
+    F[e][k] = min{ G[s][k] + setupc[s]
+                   + sum(s<=t<e) c[t](L[k]) : s < e }
+    G[s][k] = min{ F[s][j] : j < k }
+  solves it exactly in O(T^2 |L|) = O(T^3) time, for any
+  budget; the budget only enters through A[t].
+********************************************************/
+
+#ifndef XBROBUST_H
+#define XBROBUST_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+/* Protection levels A[t] for the budgets gamma[t] (fractional) */
+static inline void robProtection(int T, const double *dev, const double *gamma, double *A) {
+    int t, u;
+    double g;
+    std::vector<double> sorted;
+
+    for (t = 0; t < T; t++) {
+        sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), dev[t], std::greater<double>()), dev[t]);
+        A[t] = 0;
+        g = std::min(gamma[t], (double) (t + 1));
+        for (u = 0; u < t + 1 && g > 0; u++, g -= 1)
+            A[t] += sorted[u] * std::min(1.0, g);
+    }
+}
+
+/* Worst-case stock cost of period t at the cumulative production P */
+static inline double robStockCost(double P, double Dc, double A, double holdc, double shortc) {
+    return std::max(holdc * (P - Dc + A), shortc * (Dc + A - P));
+}
+
+/**************************************************************************/
+/* Input data:                                                            */
+/*   T:          Number of periods                                        */
+/*   dem[t]:     Nominal demand in period t                               */
+/*   dev[t]:     Max. deviation of the demand in period t                 */
+/*   gamma[t]:   Budget: max. number of deviating periods in 0..t         */
+/*   setupc[t]:  Setup cost in period t                                   */
+/*   holdc:      Unit holding cost per period                             */
+/*   shortc:     Unit backlog cost per period                             */
+/* Return values:                                                         */
+/*   prod[t]:    Production in period t of a robust plan (may be NULL)    */
+/*   setup[t]:   1 if there is a setup in period t (may be NULL)          */
+/*   F:          Worst-case cost of the robust plan                       */
+/**************************************************************************/
+static inline double robSolve(int T, const double *dem, const double *dev, const double *gamma,
+                              const double *setupc, double holdc, double shortc, double *prod, int *setup) {
+    int s, e, k, t, K, bestk;
+    double c, best;
+    std::vector<double> A(T), Dc(T), L, F;
+    std::vector<int> preds, predk;
+
+    robProtection(T, dev, gamma, &A[0]);
+    L.push_back(0);                           /* Candidate levels */
+    for (c = 0, t = 0; t < T; t++) {
+        c += dem[t];
+        Dc[t] = c;
+        L.push_back(std::max(0.0, Dc[t] + A[t] * (shortc - holdc) / (shortc + holdc)));
+    }
+    std::sort(L.begin(), L.end());
+    L.erase(std::unique(L.begin(), L.end()), L.end());
+    K = (int) L.size();
+
+    /* F[e*K+k]: cost of periods 0..e-1 ending at level L[k]; the last
+       setup before e is in preds[], coming from level predk[] */
+    F.assign((size_t) (T + 1) * K, 1e300);
+    preds.assign((size_t) (T + 1) * K, -1);
+    predk.assign((size_t) (T + 1) * K, -1);
+    F[0] = 0;                                 /* No setup yet: level 0 */
+    for (c = 0, e = 1; e <= T; e++) {
+        c += robStockCost(0, Dc[e - 1], A[e - 1], holdc, shortc);
+        F[(size_t) e * K] = c;
+    }
+
+    for (s = 0; s < T; s++)
+        for (best = F[(size_t) s * K], bestk = 0, k = 1; k < K; k++) {
+            /* best: min F[s][j], j < k */
+            for (c = best + setupc[s], e = s + 1; e <= T; e++) {
+                c += robStockCost(L[k], Dc[e - 1], A[e - 1], holdc, shortc);
+                if (c < F[(size_t) e * K + k]) {
+                    F[(size_t) e * K + k] = c;
+                    preds[(size_t) e * K + k] = s;
+                    predk[(size_t) e * K + k] = bestk;
+                }
+            }
+            if (F[(size_t) s * K + k] < best) {
+                best = F[(size_t) s * K + k];
+                bestk = k;
+            }
+        }
+
+    for (best = 1e300, bestk = 0, k = 0; k < K; k++)
+        if (F[(size_t) T * K + k] < best) {
+            best = F[(size_t) T * K + k];
+            bestk = k;
+        }
+    for (t = 0; t < T; t++) {
+        if (prod != NULL) prod[t] = 0;
+        if (setup != NULL) setup[t] = 0;
+    }
+    for (e = T, k = bestk; (s = preds[(size_t) e * K + k]) >= 0; e = s, k = t) {   /* Recover the plan */
+        t = predk[(size_t) e * K + k];
+        if (setup != NULL) setup[s] = 1;
+        if (prod != NULL) prod[s] = L[k] - L[t];
+    }
+
+    return best;
+}
+
+#endif
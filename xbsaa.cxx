@@ -0,0 +1,333 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbsaa.cxx
+  ``````````````
+  Sample average approximation (SAA) of the stochastic
+  economic lot sizing problem: the setups y[t] and the
+  production x[t] of one item are fixed before the
+  demand is known; stock costs holdc and backlog shortc
+  per unit and period in every demand scenario.
+
+  The SAA problem on N scenarios is the two-stage MIP
+    min  sum(t) setupc*y[t]
+         + 1/N sum(s,t) holdc*ip[s][t] + shortc*im[s][t]
+    s.t. x[t] <= M[t]*y[t]
+         ip[s][t] - im[s][t] = P[t] - D[s][t]
+  with the cumulative production P[t] and demand
+  D[s][t] of scenario s up to period t.
+
+  Statistical bounds (Mak, Morton and Wood, 1999):
+    lower bound: the mean optimal value of NREP
+      independent SAA problems (replications)
+    upper bound: the cost of a candidate plan on an
+      independent evaluation sample of NEVAL scenarios;
+      the candidate is the best replication plan on a
+      separate selection sample
+    gap: upper minus lower bound; the upper limit of its
+      one-sided 95% confidence interval combines both
+      confidence intervals
+
+  Starting with N = N0 the sample size is doubled until
+  the upper limit of the gap is below GAPTARGET times
+  the upper bound. The replications are solved in
+  parallel, each on its own problem; on doubling N a
+  problem keeps its scenarios and rows, only the new
+  scenarios are added, the objective weight of the
+  setups is updated and the last plan is the start
+  solution.
+
+  The evaluation of the plans uses the scenario
+  evaluator of xbscen.h.
+
+  Usage: xbsaa [datafile | -gen N T util seed] [-item i]
+               [-cv x] [-shortc x] [-rep n] [-n0 n]
+               [-nmax n] [-gap x] [-threads n]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "xprb_cpp.h"
+#include "xprs.h"
+#include "xbcls.h"
+#include "xbscen.h"
+#include "xbthreads.h"
+
+using namespace std;
+using namespace ::dashoptimization;
+
+#define NEVAL 20000            /* Scenarios of the upper bound estimate */
+#define NSELECT 5000           /* Scenarios of the candidate selection */
+#define ZALPHA 1.645           /* One-sided 95% normal quantile */
+
+/****DATA****/
+CLSData DT;                             /* Demand series and costs */
+int ITEM = 0;                           /* Item of the data used */
+int T;                                  /* Number of periods */
+vector<double> MEAN;                    /* Mean demand per period */
+double SETUPC, HOLDC, SHORTC;           /* Setup, holding and backlog cost */
+double CV = 0.3;                        /* Variation coefficient of demand */
+int NREP = 10;                          /* Replications */
+int N0 = 16;                            /* Initial sample size */
+int NMAX = 1024;                        /* Max. sample size */
+double GAPTARGET = 0.01;                /* Target of the relative gap */
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+
+typedef struct {                        /* SAA problem of one replication */
+    XPRBprob *prob;
+    vector<XPRBvar> y, x, P;            /* Setup, production, cumulative prod. */
+    XPRBvar fc;                         /* Setup cost */
+    XPRBctr cobj;                       /* Objective: N times the SAA cost */
+    ScenSet sc;                         /* Scenarios in the problem */
+    unsigned seed;
+    double val;                         /* Optimal value, else the MIP bound */
+    vector<int> setup;                  /* Plan of the last solve */
+    vector<double> prod;
+} SAAModel;
+
+CLSStats stats;
+
+/***********************************************************************/
+
+/* One-sided 95% quantile of Student's t distribution with df degrees
+   of freedom */
+double tQuantile(int df) {
+    static const double q[] = {6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+                               1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725};
+
+    if (df < 1) return HUGE_VAL;
+    return df <= 20 ? q[df - 1] : ZALPHA + 2.4 / df;
+}
+
+/**************************************************************************/
+/*  First stage of the SAA problem without scenarios                      */
+/**************************************************************************/
+void modSaa(SAAModel *m, int rep) {
+    int t;
+    double M = 0;
+    XPRBprob &p = *m->prob;
+    XPRBexpr le;
+
+    m->y.resize(T);
+    m->x.resize(T);
+    m->P.resize(T);
+    for (t = 0; t < T; t++) {
+        m->y[t] = p.newVar(XPRBnewname("y%d", t + 1), XPRB_BV);
+        m->x[t] = p.newVar(XPRBnewname("x%d", t + 1));
+        m->P[t] = p.newVar(XPRBnewname("P%d", t + 1));
+    }
+    m->fc = p.newVar("fc");
+
+    for (t = T - 1; t >= 0; t--) {                /* Production needs a setup */
+        M += MEAN[t] * (1 + 4 * CV);
+        p.newCtr("Setup", m->x[t] <= M * m->y[t]);
+    }
+    for (t = 0; t < T; t++) {                     /* Cumulative production */
+        le = m->P[t] - m->x[t];
+        if (t > 0) le -= m->P[t - 1];
+        p.newCtr("Cum", le == 0);
+    }
+    le = 0;
+    for (t = 0; t < T; t++)
+        le += SETUPC * m->y[t];
+    p.newCtr("SetupCost", m->fc == le);
+
+    le = m->fc;
+    m->cobj = p.newCtr("OBJ", le);
+    p.setObj(m->cobj);
+    m->sc.nscen = 0;
+    m->seed = 1000 + rep;
+}
+
+/**************************************************************************/
+/*  Extend the problem to n scenarios: generating n scenarios from the    */
+/*  same seed repeats the first ones, only the new ones are added         */
+/**************************************************************************/
+void extendSaa(SAAModel *m, int n) {
+    int s, t, n0 = m->sc.nscen;
+    XPRBprob &p = *m->prob;
+    XPRBvar ip, im;
+    double D;
+
+    scenGenerate(&m->sc, T, n, &MEAN[0], CV, m->seed);
+    for (s = n0; s < n; s++)
+        for (D = 0, t = 0; t < T; t++) {
+            D += m->sc.dem[(size_t) t * m->sc.S + s];
+            ip = p.newVar(XPRBnewname("ip%d_%d", s + 1, t + 1));
+            im = p.newVar(XPRBnewname("im%d_%d", s + 1, t + 1));
+            p.newCtr("Stock", ip - im - m->P[t] == -D);
+            m->cobj += HOLDC * ip + SHORTC * im;
+        }
+    m->cobj.setTerm(m->fc, n);
+}
+
+/*  Solve the SAA problem from the last plan; 0 if there is no solution.  */
+/*  The value for the lower bound is the MIP bound unless proven optimal; */
+/*  the incumbent plan still serves as a candidate.                       */
+int solveSaa(SAAModel *m) {
+    int t;
+    double bd;
+    XPRBsol start;
+
+    if (!m->setup.empty()) {
+        start = m->prob->newSol();
+        for (t = 0; t < T; t++) {
+            start.setVar(m->y[t], m->setup[t]);
+            start.setVar(m->x[t], m->prod[t]);
+        }
+        m->prob->addMIPSol(start);
+    }
+    m->prob->mipOptimize("");
+    if (m->prob->getMIPStat() != XPRB_MIP_OPTIMAL && m->prob->getMIPStat() != XPRB_MIP_SOLUTION)
+        return 0;
+    if (m->prob->getMIPStat() == XPRB_MIP_OPTIMAL)
+        m->val = m->prob->getObjVal() / m->sc.nscen;
+    else {
+        XPRSgetdblattrib(m->prob->getXPRSprob(), XPRS_BESTBOUND, &bd);
+        m->val = bd / m->sc.nscen;
+    }
+    m->setup.resize(T);
+    m->prod.resize(T);
+    for (t = 0; t < T; t++) {
+        m->setup[t] = (m->y[t].getSol() > 0.5);
+        m->prod[t] = max(0.0, m->x[t].getSol());
+    }
+    return 1;
+}
+
+/*  Mean and standard deviation of the cost of the plan on sc */
+void evalPlan(const SAAModel *m, const ScenSet &sc, double *mean, double *sd) {
+    int s, t;
+    double fc = 0, var = 0;
+    vector<double> cost(sc.nscen);
+
+    for (t = 0; t < T; t++) fc += SETUPC * m->setup[t];
+    *mean = fc + scenEvaluate(&sc, &m->prod[0], HOLDC, SHORTC, &cost[0]).mean;
+    for (s = 0; s < sc.nscen; s++)
+        var += (fc + cost[s] - *mean) * (fc + cost[s] - *mean);
+    *sd = sqrt(var / max(1, sc.nscen - 1));
+}
+
+/**************************************************************************/
+/*  SAA loop with sample sizes N0, 2*N0, ... up to NMAX                   */
+/**************************************************************************/
+void solveSaaAdaptive() {
+    int k, n, best = 0;
+    double t0, lb, sdlb, ub, sdub, lbci, ubci, gap, gapci, z, sd, zbest = HUGE_VAL;
+    vector<SAAModel> model(NREP);
+    vector<int> ok(NREP);
+    ScenSet select, eval;
+
+    scenGenerate(&select, T, NSELECT, &MEAN[0], CV, 1);
+    scenGenerate(&eval, T, NEVAL, &MEAN[0], CV, 2);
+    for (k = 0; k < NREP; k++) {
+        model[k].prob = new XPRBprob(XPRBnewname("Saa%d", k + 1));
+        modSaa(&model[k], k);
+        XPRSsetintcontrol(model[k].prob->getXPRSprob(), XPRS_THREADS, 1);
+    }
+
+    cout << "     N   lower bound (95%)     upper bound (95%)     gap    gap limit" << endl;
+    for (n = N0; n <= NMAX; n *= 2) {
+        t0 = clsClock();                          /* Add the new scenarios */
+        for (k = 0; k < NREP; k++) extendSaa(&model[k], n);
+        clsRecord(&stats, "model extension", clsClock() - t0, NREP);
+
+        t0 = clsClock();                          /* Replications in parallel */
+        xbParallelChunks(NREP, 1, NTHREADS, [&](int lo, int hi, int c) {
+            ok[c] = solveSaa(&model[c]);
+        });
+        clsRecord(&stats, "SAA solves", clsClock() - t0, NREP);
+        for (k = 0; k < NREP; k++)
+            if (!ok[k]) {
+                cout << "Replication " << k + 1 << ": no solution for N = " << n << endl;
+                return;
+            }
+
+        t0 = clsClock();
+        for (lb = 0, k = 0; k < NREP; k++) lb += model[k].val / NREP;
+        for (sdlb = 0, k = 0; k < NREP; k++) sdlb += (model[k].val - lb) * (model[k].val - lb);
+        sdlb = sqrt(sdlb / max(1, NREP - 1));
+        for (best = 0, k = 0; k < NREP; k++) {    /* Candidate plan */
+            evalPlan(&model[k], select, &z, &sd);
+            if (k == 0 || z < zbest) {
+                zbest = z;
+                best = k;
+            }
+        }
+        evalPlan(&model[best], eval, &ub, &sdub);
+        clsRecord(&stats, "bound estimates", clsClock() - t0, NREP + 1);
+
+        lbci = tQuantile(NREP - 1) * sdlb / sqrt((double) NREP);
+        ubci = ZALPHA * sdub / sqrt((double) NEVAL);
+        gap = ub - lb;
+        gapci = max(0.0, gap) + lbci + ubci;
+        cout.width(6);
+        cout << n << "   " << lb << " -" << lbci << "   " << ub << " +" << ubci << "   "
+             << 100 * gap / ub << "%   " << 100 * gapci / ub << "%" << endl;
+        if (gapci <= GAPTARGET * ub) {
+            cout << "Target gap " << 100 * GAPTARGET << "% reached with N = " << n << endl;
+            break;
+        }
+        if (2 * n > NMAX)
+            cout << "Target gap " << 100 * GAPTARGET << "% not reached up to N = " << NMAX << endl;
+    }
+
+    if (!model[best].setup.empty()) {
+        cout << "Plan: setups";
+        for (k = 0; k < T; k++)
+            if (model[best].setup[k]) cout << " " << k + 1;
+        cout << endl;
+    }
+    for (k = 0; k < NREP; k++)
+        delete model[k].prob;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i;
+
+    SHORTC = -1;
+    clsGenerate(&DT, 1, 52, 0.8, 1);
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-item") && i + 1 < argc)
+            ITEM = atoi(argv[++i]) - 1;
+        else if (!strcmp(argv[i], "-cv") && i + 1 < argc)
+            CV = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-shortc") && i + 1 < argc)
+            SHORTC = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-rep") && i + 1 < argc)
+            NREP = max(2, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-n0") && i + 1 < argc)
+            N0 = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-nmax") && i + 1 < argc)
+            NMAX = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-gap") && i + 1 < argc)
+            GAPTARGET = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    if (ITEM < 0 || ITEM >= DT.N) ITEM = 0;
+    T = DT.T;
+    MEAN.assign(DT.dem.begin() + ITEM * T, DT.dem.begin() + (ITEM + 1) * T);
+    SETUPC = DT.setupc[ITEM];
+    HOLDC = DT.holdc[ITEM];
+    if (SHORTC < 0) SHORTC = 10 * HOLDC;   /* Default backlog cost */
+
+    solveSaaAdaptive();
+    clsPrintStats(&stats);
+
+    return 0;
+}
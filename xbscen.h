@@ -0,0 +1,188 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbscen.h
+  `````````````
+  Evaluation of a production plan under many demand
+  scenarios.
+
+  The scenarios are stored period-major (structure of
+  arrays): the demands of all scenarios for period t are
+  contiguous, dem[t*S+s]. For a group of SCENLANES
+  scenarios the evaluator keeps the cumulative demand
+  and the cost of every scenario in a small array and
+  runs over the periods once; the inner loop over the
+  lanes has no branches and unit stride, so that the
+  compiler turns it into SIMD instructions.
+
+  With P[t] the cumulative production and D[0][t] the
+  cumulative demand of a scenario up to period t, the
+  stock at the end of t is P[t] - D[0][t]; a positive
+  stock costs holdc, a negative one (backlog) shortc per
+  unit and period.
+********************************************************/
+
+#ifndef XBSCEN_H
+#define XBSCEN_H
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#define SCENLANES 16                    /* Scenarios per lane group */
+
+typedef struct {
+    int T;                              /* Number of periods */
+    int nscen;                          /* Number of scenarios */
+    int S;                              /* nscen rounded up to SCENLANES */
+    std::vector<double> dem;            /* dem[t*S+s]: period-major */
+} ScenSet;
+
+typedef struct {
+    double mean;                        /* Mean holding and shortage cost */
+    double service;                     /* Fraction of scenarios without shortage */
+} ScenResult;
+
+/**************************************************************************/
+/* nscen scenarios with normal demand around mean[t] with variation       */
+/* coefficient cv, cut at 0. The padding scenarios have zero demand.      */
+/**************************************************************************/
+static inline void scenGenerate(ScenSet *sc, int T, int nscen, const double *mean, double cv, unsigned seed) {
+    int s, t;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> N01(0.0, 1.0);
+
+    sc->T = T;
+    sc->nscen = nscen;
+    sc->S = (nscen + SCENLANES - 1) / SCENLANES * SCENLANES;
+    sc->dem.assign((size_t) T * sc->S, 0.0);
+    for (s = 0; s < nscen; s++)
+        for (t = 0; t < T; t++)
+            sc->dem[(size_t) t * sc->S + s] = std::max(0.0, mean[t] * (1 + cv * N01(rng)));
+}
+
+/**************************************************************************/
+/* Cost of the plan prod[] in every scenario (cost[s], may be NULL) for   */
+/* the demands dem[t*S+s] of nscen scenarios in any memory (e.g. a        */
+/* shared-memory request, see xbshm.h)                                    */
+/**************************************************************************/
+static inline ScenResult scenEvaluateData(int T, int nscen, int S, const double *dem, const double *prod,
+                                          double holdc, double shortc, double *cost) {
+    int b, l, t, nok = 0;
+    double P, inv, sum = 0;
+    double cum[SCENLANES], c[SCENLANES], sh[SCENLANES];
+    const double *d;
+    ScenResult res;
+
+    for (b = 0; b < S; b += SCENLANES) {
+        for (l = 0; l < SCENLANES; l++) cum[l] = c[l] = sh[l] = 0;
+        P = 0;
+        for (t = 0; t < T; t++) {
+            P += prod[t];
+            d = &dem[(size_t) t * S + b];
+            for (l = 0; l < SCENLANES; l++) {
+                cum[l] += d[l];
+                inv = P - cum[l];
+                c[l] += holdc * std::max(inv, 0.0) + shortc * std::max(-inv, 0.0);
+                sh[l] += std::max(-inv, 0.0);
+            }
+        }
+        for (l = 0; l < SCENLANES && b + l < nscen; l++) {
+            if (cost != NULL) cost[b + l] = c[l];
+            sum += c[l];
+            nok += (sh[l] <= 0);
+        }
+    }
+    res.mean = sum / nscen;
+    res.service = (double) nok / nscen;
+    return res;
+}
+
+/* Same for a scenario set */
+static inline ScenResult scenEvaluate(const ScenSet *sc, const double *prod, double holdc, double shortc,
+                                      double *cost) {
+    return scenEvaluateData(sc->T, sc->nscen, sc->S, &sc->dem[0], prod, holdc, shortc, cost);
+}
+
+/**************************************************************************/
+/* Same for a realized production per scenario, real[t*S+s] in the layout */
+/* of the demands (e.g. from the simulation of the line, xbdes.h)         */
+/**************************************************************************/
+static inline ScenResult scenEvaluateReal(const ScenSet *sc, const double *real, double holdc, double shortc,
+                                          double *cost) {
+    int b, l, t, nok = 0;
+    double inv, sum = 0;
+    double cum[SCENLANES], P[SCENLANES], c[SCENLANES], sh[SCENLANES];
+    const double *d, *r;
+    ScenResult res;
+
+    for (b = 0; b < sc->S; b += SCENLANES) {
+        for (l = 0; l < SCENLANES; l++) cum[l] = P[l] = c[l] = sh[l] = 0;
+        for (t = 0; t < sc->T; t++) {
+            d = &sc->dem[(size_t) t * sc->S + b];
+            r = &real[(size_t) t * sc->S + b];
+            for (l = 0; l < SCENLANES; l++) {
+                cum[l] += d[l];
+                P[l] += r[l];
+                inv = P[l] - cum[l];
+                c[l] += holdc * std::max(inv, 0.0) + shortc * std::max(-inv, 0.0);
+                sh[l] += std::max(-inv, 0.0);
+            }
+        }
+        for (l = 0; l < SCENLANES && b + l < sc->nscen; l++) {
+            if (cost != NULL) cost[b + l] = c[l];
+            sum += c[l];
+            nok += (sh[l] <= 0);
+        }
+    }
+    res.mean = sum / sc->nscen;
+    res.service = (double) nok / sc->nscen;
+    return res;
+}
+
+/**************************************************************************/
+/* Reference evaluation one scenario at a time on the scenario-major      */
+/* copy demsm[s*T+t] of the demands                                        */
+/**************************************************************************/
+static inline ScenResult scenEvaluateScalar(const ScenSet *sc, const double *demsm, const double *prod,
+                                            double holdc, double shortc, double *cost) {
+    int s, t, nok = 0;
+    double P, D, inv, c, sum = 0;
+    bool shortage;
+    ScenResult res;
+
+    for (s = 0; s < sc->nscen; s++) {
+        P = D = c = 0;
+        shortage = false;
+        for (t = 0; t < sc->T; t++) {
+            P += prod[t];
+            D += demsm[(size_t) s * sc->T + t];
+            inv = P - D;
+            if (inv >= 0)
+                c += holdc * inv;
+            else {
+                c -= shortc * inv;
+                shortage = true;
+            }
+        }
+        if (cost != NULL) cost[s] = c;
+        sum += c;
+        if (!shortage) nok++;
+    }
+    res.mean = sum / sc->nscen;
+    res.service = (double) nok / sc->nscen;
+    return res;
+}
+
+/* Scenario-major copy of the demands */
+static inline void scenTranspose(const ScenSet *sc, std::vector<double> &demsm) {
+    int s, t;
+
+    demsm.resize((size_t) sc->nscen * sc->T);
+    for (s = 0; s < sc->nscen; s++)
+        for (t = 0; t < sc->T; t++)
+            demsm[(size_t) s * sc->T + t] = sc->dem[(size_t) t * sc->S + s];
+}
+
+#endif
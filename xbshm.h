@@ -0,0 +1,251 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbshm.h
+  ````````````
+  Shared-memory transport between the clients and a
+  solve service (see xbsolved.cxx).
+
+  The service creates a POSIX shared-memory region of
+  XBSHMSLOTS slots of XBSHMSLOTBYTES bytes each, mapped
+  by every client. A client takes a free slot (the
+  slots form a ring: the search starts after the slot
+  taken last), writes its request directly into the
+  mapped slot and sends a control message with the slot
+  number over a Unix domain socket. The service reads
+  the request in place, writes the result into the same
+  slot and answers with a control message; the client
+  reads the result in place and frees the slot. The
+  data is never copied or sent through the socket; a
+  control message is XBShmMsg, 16 bytes.
+
+  The slot states are atomics in the region, so they
+  are shared by all processes. The state of a taken
+  slot is the pid of the client process that took it;
+  while the service works on the slot it also carries
+  XBSHM_SERVING, and the service only does so for a slot
+  owned by the process at the other end of the socket.
+  When no slot is free, xbShmTake() frees the slots of
+  owners that have died without freeing them and are
+  not being served.
+********************************************************/
+
+#ifndef XBSHM_H
+#define XBSHM_H
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define XBSHMMAGIC 0x31485358u          /* "XSH1" */
+#define XBSHMSLOTS 8                    /* Requests in flight */
+#define XBSHMSLOTBYTES (8u << 20)       /* Bytes per slot */
+#define XBSHMHDRBYTES 4096              /* Header, slots are page-aligned */
+
+#define XBSHM_FREE 0                    /* Else: pid of the owner */
+#define XBSHM_SERVING 0x80000000u       /* Flag: the service works on the slot */
+
+typedef struct {
+    uint32_t magic, nslots;
+    uint64_t slotbytes;
+    std::atomic<uint32_t> next;         /* Ring position of the next search */
+    std::atomic<uint32_t> state[XBSHMSLOTS];   /* XBSHM_FREE or owner pid */
+} XBShmHeader;
+
+typedef struct {
+    uint32_t op;                        /* Request type, defined by the service */
+    uint32_t slot;
+    int32_t status;                     /* Answer: 0 if solved */
+    uint32_t pad;
+} XBShmMsg;
+
+typedef struct {
+    int fd;                             /* Shared-memory object, -1 if none */
+    char *base;
+    XBShmHeader *hdr;
+} XBShm;
+
+static inline size_t xbShmSize() {
+    return XBSHMHDRBYTES + (size_t) XBSHMSLOTS * XBSHMSLOTBYTES;
+}
+
+/* Service: create (or recreate) the region 'name' (e.g. "/xbsolved") */
+static inline int xbShmCreate(XBShm *m, const char *name) {
+    int k;
+
+    shm_unlink(name);
+    m->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (m->fd < 0) return 0;
+    if (ftruncate(m->fd, xbShmSize()) < 0 ||
+        (m->base = (char *) mmap(NULL, xbShmSize(), PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0)) ==
+            (char *) MAP_FAILED) {
+        close(m->fd);
+        shm_unlink(name);
+        m->fd = -1;
+        return 0;
+    }
+    m->hdr = (XBShmHeader *) m->base;
+    m->hdr->nslots = XBSHMSLOTS;
+    m->hdr->slotbytes = XBSHMSLOTBYTES;
+    m->hdr->next = 0;
+    for (k = 0; k < XBSHMSLOTS; k++) m->hdr->state[k] = XBSHM_FREE;
+    std::atomic_thread_fence(std::memory_order_release);
+    m->hdr->magic = XBSHMMAGIC;
+    return 1;
+}
+
+/* Client: map the region of a running service */
+static inline int xbShmAttach(XBShm *m, const char *name) {
+    m->fd = shm_open(name, O_RDWR, 0);
+    if (m->fd < 0) return 0;
+    m->base = (char *) mmap(NULL, xbShmSize(), PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+    if (m->base == (char *) MAP_FAILED) {
+        close(m->fd);
+        m->fd = -1;
+        return 0;
+    }
+    m->hdr = (XBShmHeader *) m->base;
+    if (m->hdr->magic != XBSHMMAGIC || m->hdr->nslots != XBSHMSLOTS || m->hdr->slotbytes != XBSHMSLOTBYTES) {
+        munmap(m->base, xbShmSize());
+        close(m->fd);
+        m->fd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+static inline void xbShmDetach(XBShm *m) {
+    if (m->fd < 0) return;
+    munmap(m->base, xbShmSize());
+    close(m->fd);
+    m->fd = -1;
+}
+
+static inline char *xbShmSlot(const XBShm *m, int k) {
+    return m->base + XBSHMHDRBYTES + (size_t) k * XBSHMSLOTBYTES;
+}
+
+/* Free the slots of dead owners. Return value: number of slots freed */
+static inline int xbShmReclaim(XBShm *m) {
+    int k, n = 0;
+    uint32_t s;
+
+    for (k = 0; k < XBSHMSLOTS; k++) {
+        s = m->hdr->state[k].load(std::memory_order_acquire);
+        if (s == XBSHM_FREE || (s & XBSHM_SERVING)) continue;
+        if (kill((pid_t) s, 0) < 0 && errno == ESRCH &&
+            m->hdr->state[k].compare_exchange_strong(s, XBSHM_FREE, std::memory_order_acq_rel))
+            n++;
+    }
+    return n;
+}
+
+/* Take a free slot. Return value: slot number, -1 if all are taken */
+static inline int xbShmTake(XBShm *m) {
+    int i, k, pass;
+    uint32_t freest;
+
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < XBSHMSLOTS; i++) {
+            k = (int) (m->hdr->next.fetch_add(1) % XBSHMSLOTS);
+            freest = XBSHM_FREE;
+            if (m->hdr->state[k].compare_exchange_strong(freest, (uint32_t) getpid(), std::memory_order_acquire))
+                return k;
+        }
+        if (pass == 0 && xbShmReclaim(m) == 0) break;
+    }
+    return -1;
+}
+
+static inline void xbShmFree(XBShm *m, int k) {
+    m->hdr->state[k].store(XBSHM_FREE, std::memory_order_release);
+}
+
+/* Service: mark slot k of client process pid as served. Return value: 0 if pid does not own it */
+static inline int xbShmServe(XBShm *m, int k, pid_t pid) {
+    uint32_t s = (uint32_t) pid;
+
+    return m->hdr->state[k].compare_exchange_strong(s, (uint32_t) pid | XBSHM_SERVING,
+                                                    std::memory_order_acquire);
+}
+
+static inline void xbShmServed(XBShm *m, int k, pid_t pid) {
+    m->hdr->state[k].store((uint32_t) pid, std::memory_order_release);
+}
+
+/**************************************************************************/
+/* Control channel: Unix domain stream socket at 'path'                   */
+/**************************************************************************/
+static inline int xbShmListen(const char *path) {
+    int fd;
+    struct sockaddr_un a;
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) return -1;
+    memset(&a, 0, sizeof(a));
+    a.sun_family = AF_UNIX;
+    strncpy(a.sun_path, path, sizeof(a.sun_path) - 1);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &a, sizeof(a)) < 0 || listen(fd, 16) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static inline int xbShmConnect(const char *path) {
+    int fd;
+    struct sockaddr_un a;
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) return -1;
+    memset(&a, 0, sizeof(a));
+    a.sun_family = AF_UNIX;
+    strncpy(a.sun_path, path, sizeof(a.sun_path) - 1);
+    if (connect(fd, (struct sockaddr *) &a, sizeof(a)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Pid of the process at the other end of a connection, -1 if unknown */
+static inline pid_t xbShmPeer(int fd) {
+    struct ucred cr;
+    socklen_t len = sizeof(cr);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cr, &len) < 0) return -1;
+    return cr.pid;
+}
+
+/* Return value: 0 if the connection is closed or broken */
+static inline int xbShmSend(int fd, const XBShmMsg *msg) {
+    size_t n = 0;
+    ssize_t r;
+
+    while (n < sizeof(*msg)) {
+        if ((r = send(fd, (const char *) msg + n, sizeof(*msg) - n, MSG_NOSIGNAL)) <= 0) return 0;
+        n += r;
+    }
+    return 1;
+}
+
+static inline int xbShmRecv(int fd, XBShmMsg *msg) {
+    size_t n = 0;
+    ssize_t r;
+
+    while (n < sizeof(*msg)) {
+        if ((r = recv(fd, (char *) msg + n, sizeof(*msg) - n, 0)) <= 0) return 0;
+        n += r;
+    }
+    return 1;
+}
+
+#endif
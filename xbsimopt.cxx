@@ -0,0 +1,568 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbsimopt.cxx
+  `````````````````
+  Simulation-based optimization of a lot sizing plan
+  (see SimulationBasedOptimization.xml):
+    a population of feasible plans generated by
+      heuristics (Wagner-Whitin on the mean demand and
+      perturbations of it)
+    randomly generated demand scenarios
+    evaluation of every plan in every scenario
+    summary: mean holding and backlog cost, service
+    evolution: selection, crossover and mutation
+
+  A plan consists of the setup periods setup[t] and a
+  safety factor; in a setup period production brings
+  the cumulative production up to the mean cumulative
+  demand until the next setup plus the safety factor
+  times the demand of this cycle.
+
+  The scenarios are evaluated with the structure-of-
+  arrays evaluator of xbscen.h. With -bench it is
+  compared with the per-scenario scalar loop.
+
+  With -des the production of a plan in each scenario
+  is not the planned one but the result of a discrete-
+  event simulation of the line (xbdes.h) with random
+  processing and setup times and breakdowns; -desbench
+  reports the event rate of the simulation. A
+  simulation costs far more than a planned evaluation,
+  so -des is used with a few hundred scenarios.
+
+  With -islands n the population is split into n
+  islands that evolve on their own thread without any
+  synchronization; every MIGRATE generations the best
+  plans of an island are sent to the next island of a
+  ring through a lock-free queue. -scaling runs 1, 2,
+  4, ..., 64 islands of -pop plans each and reports the
+  parallel efficiency (time for one island divided by
+  the time for n islands).
+
+  With -numa the islands are pinned to the NUMA nodes
+  (xbnuma.h) in contiguous blocks, so that neighbours in
+  the migration ring share a node; an island allocates
+  its population on its node and reads a copy of the
+  scenarios made on that node. -numabench reports the
+  throughput (plan-scenario evaluations per second) of
+  one island per core on 1, 2, ... nodes, pinned with
+  shared or with node-local scenarios, and unpinned on
+  all nodes.
+
+  The initial population contains the robust plan of
+  xbrobust.h for the demand ranges mean*(1 +- cv) and the
+  budget -gamma (periods that deviate at the same time),
+  converted to setups and a safety factor.
+
+  Usage: xbsimopt [datafile | -gen N T util seed] [-item i]
+                  [-scen n] [-cv x] [-shortc x] [-pop n]
+                  [-gens n] [-threads n] [-des] [-gamma x]
+                  [-islands n] [-numa]
+                  [-bench | -desbench | -scaling | -numabench]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include "xbcls.h"
+#include "xbww.h"
+#include "xbscen.h"
+#include "xbdes.h"
+#include "xbrobust.h"
+#include "xbthreads.h"
+#include "xbnuma.h"
+
+using namespace std;
+
+#define ELITE 4                /* Plans kept unchanged per generation */
+#define TOURNAMENT 3           /* Tournament size of the selection */
+#define MUTATION 0.05          /* Probability to flip a setup */
+#define MAXSAFETY 1.0          /* Upper bound of the safety factor */
+#define BENCHPLANS 200         /* Plans evaluated in the benchmark */
+#define LINEUTIL 0.75          /* Share of a period the line is processing */
+#define MIGRATE 5              /* Generations between migrations */
+#define MIGRANTS 2             /* Plans sent per migration */
+#define MAXISLANDS 64          /* Islands of the scaling report */
+
+/****DATA****/
+CLSData DT;                             /* Demand series and costs */
+int ITEM = 0;                           /* Item of the data used */
+int T;                                  /* Number of periods */
+vector<double> MEAN;                    /* Mean demand per period */
+double SETUPC, HOLDC, SHORTC;           /* Setup, holding and backlog cost */
+double CV = 0.3;                        /* Variation coefficient of demand */
+int NTHREADS = 0;                       /* Threads, 0 for one per core */
+double GAMMA = 3;                       /* Budget of the robust seed plan */
+int USEDES = 0;                         /* Simulate the line */
+XBNuma NUMA;                            /* Nodes and their cores */
+int PIN = 0;                            /* Pin the islands to the nodes */
+DESLine LINE;                           /* Line parameters */
+atomic<long> DESEVENTS(0);              /* Simulated events */
+
+typedef struct {
+    vector<int> setup;                  /* Setup periods */
+    double safety;                      /* Safety factor */
+    double fit;                         /* Setup cost + mean cost */
+    double service;                     /* Fraction of scenarios served */
+} Plan;
+
+CLSStats stats;
+
+/***********************************************************************/
+
+/*  Production of a plan */
+void planProd(const Plan &pl, double *prod) {
+    int t, u;
+    double P = 0, D = 0, cyc, target;
+
+    for (t = 0; t < T; t++) {
+        prod[t] = 0;
+        if (pl.setup[t]) {
+            for (cyc = 0, u = t; u < T && (u == t || !pl.setup[u]); u++)
+                cyc += MEAN[u];
+            target = D + cyc * (1 + pl.safety);
+            prod[t] = max(0.0, target - P);
+            P += prod[t];
+        }
+        D += MEAN[t];
+    }
+}
+
+/*  Production of the plan simulated in every scenario, real[t*S+s] */
+void simulate(const Plan &pl, const double *prod, const ScenSet &sc, vector<double> &real) {
+    int s;
+    long nev = 0;
+    DESQueue q;
+
+    real.assign((size_t) T * sc.S, 0.0);
+    for (s = 0; s < sc.nscen; s++)      /* Same random numbers for all plans */
+        nev += desRunPlan(&q, &LINE, T, prod, &pl.setup[0], s + 1, &real[s], sc.S);
+    DESEVENTS += nev;
+}
+
+void evaluate(Plan &pl, const ScenSet &sc) {
+    int t;
+    vector<double> prod(T), real;
+    ScenResult res;
+
+    planProd(pl, &prod[0]);
+    if (USEDES) {
+        simulate(pl, &prod[0], sc, real);
+        res = scenEvaluateReal(&sc, &real[0], HOLDC, SHORTC, NULL);
+    } else
+        res = scenEvaluate(&sc, &prod[0], HOLDC, SHORTC, NULL);
+    pl.fit = res.mean;
+    for (t = 0; t < T; t++)
+        if (pl.setup[t]) pl.fit += SETUPC;
+    pl.service = res.service;
+}
+
+/*  Evaluate the plans in parallel */
+void evaluateAll(vector<Plan> &pop, const ScenSet &sc) {
+    double t0 = clsClock();
+
+    xbParallelChunks((int) pop.size(), 4, NTHREADS, [&](int lo, int hi, int c) {
+        for (int k = lo; k < hi; k++) evaluate(pop[k], sc);
+    });
+    clsRecord(&stats, "evaluation", clsClock() - t0, (long) pop.size() * sc.nscen);
+    if (USEDES) clsRecord(&stats, "simulated events", 0, DESEVENTS.exchange(0));
+}
+
+/**************************************************************************/
+/*  Robust plan for the demand ranges MEAN*(1 +- CV) under the budget     */
+/*  GAMMA; the safety factor is the mean relative excess of the robust    */
+/*  production levels over the mean demand of each cycle                  */
+/**************************************************************************/
+void robustPlan(Plan *pl, double *worst) {
+    int t, u, ncyc = 0;
+    double P = 0, D = 0, cyc, sum = 0;
+    vector<double> dev(T), gamma(T, GAMMA), setupc(T, SETUPC), prod(T);
+
+    for (t = 0; t < T; t++) dev[t] = CV * MEAN[t];
+    pl->setup.resize(T);
+    *worst = robSolve(T, &MEAN[0], &dev[0], &gamma[0], &setupc[0], HOLDC, SHORTC, &prod[0], &pl->setup[0]);
+    for (t = 0; t < T; t++) {
+        if (pl->setup[t]) {
+            for (cyc = 0, u = t; u < T && (u == t || !pl->setup[u]); u++)
+                cyc += MEAN[u];
+            if (cyc > 0) {
+                sum += (P + prod[t] - (D + cyc)) / cyc;
+                ncyc++;
+            }
+        }
+        P += prod[t];
+        D += MEAN[t];
+    }
+    pl->safety = min(MAXSAFETY, max(0.0, ncyc > 0 ? sum / ncyc : 0.0));
+}
+
+/**************************************************************************/
+/*  Initial population: the Wagner-Whitin plan for the mean demand, the   */
+/*  robust plan and random perturbations of the Wagner-Whitin plan.       */
+/*  Return value: worst-case cost of the robust plan (0 if none)          */
+/**************************************************************************/
+double initPopulation(vector<Plan> &pop, int popsize, mt19937 &rng) {
+    int k, t;
+    double worst = 0;
+    vector<double> setupc(T, SETUPC), prodc(T, 0), holdc(T, HOLDC);
+    uniform_real_distribution<double> U(0.0, 1.0);
+    Plan ww;
+
+    ww.setup.resize(T);
+    wwSolve(T, &MEAN[0], &setupc[0], &prodc[0], &holdc[0], NULL, &ww.setup[0]);
+    ww.safety = 0;
+    pop.assign(popsize, ww);
+    for (k = 1; k < popsize; k++) {
+        for (t = 1; t < T; t++)
+            if (U(rng) < 0.2) pop[k].setup[t] = 1 - pop[k].setup[t];
+        pop[k].safety = MAXSAFETY * U(rng) / 2;
+    }
+    if (popsize > 1) robustPlan(&pop[1], &worst);
+    return worst;
+}
+
+/*  Best of TOURNAMENT random plans */
+const Plan &select(const vector<Plan> &pop, mt19937 &rng) {
+    int k, best = rng() % pop.size();
+
+    for (k = 1; k < TOURNAMENT; k++) {
+        int c = rng() % pop.size();
+        if (pop[c].fit < pop[best].fit) best = c;
+    }
+    return pop[best];
+}
+
+/**************************************************************************/
+/*  Evolution: the ELITE best plans survive, the others are uniform       */
+/*  crossovers of two selected plans with mutation                        */
+/**************************************************************************/
+void evolve(vector<Plan> &pop, mt19937 &rng) {
+    int k, t;
+    vector<Plan> next;
+    uniform_real_distribution<double> U(0.0, 1.0);
+    normal_distribution<double> N01(0.0, 1.0);
+
+    sort(pop.begin(), pop.end(), [](const Plan &a, const Plan &b) { return a.fit < b.fit; });
+    next.assign(pop.begin(), pop.begin() + min(ELITE, (int) pop.size()));
+    while (next.size() < pop.size()) {
+        const Plan &a = select(pop, rng), &b = select(pop, rng);
+        Plan c = a;
+        for (t = 0; t < T; t++) {
+            if (U(rng) < 0.5) c.setup[t] = b.setup[t];
+            if (U(rng) < MUTATION) c.setup[t] = 1 - c.setup[t];
+        }
+        c.safety = min(MAXSAFETY, max(0.0, (a.safety + b.safety) / 2 + 0.05 * N01(rng)));
+        next.push_back(c);
+    }
+    for (k = 0; k < (int) next.size(); k++)
+        pop[k] = next[k];
+}
+
+/*  Re-evaluate the best plan on an independent scenario set */
+void report(Plan &best, int nscen) {
+    int t;
+    ScenSet test;
+
+    scenGenerate(&test, T, nscen, &MEAN[0], CV, 2);
+    evaluate(best, test);
+    cout << "Best plan: setups";
+    for (t = 0; t < T; t++)
+        if (best.setup[t]) cout << " " << t + 1;
+    cout << ", safety " << best.safety << endl;
+    cout << "Out of sample: cost " << best.fit << ", service " << 100 * best.service << "%" << endl;
+}
+
+/**************************************************************************/
+/*  Simulation-optimization loop with one population                      */
+/**************************************************************************/
+void simOpt(int popsize, int ngens, int nscen) {
+    int g;
+    double worst;
+    ScenSet sc;
+    vector<Plan> pop;
+    mt19937 rng(1);
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);
+    worst = initPopulation(pop, popsize, rng);
+    if (popsize > 1) {
+        evaluate(pop[1], sc);
+        cout << "Robust seed (budget " << GAMMA << "): worst case " << worst << ", simulated " << pop[1].fit
+             << ", service " << 100 * pop[1].service << "%" << endl;
+    }
+    for (g = 0; g < ngens; g++) {
+        evaluateAll(pop, sc);
+        evolve(pop, rng);
+        cout << "Generation " << g + 1 << ": best " << pop[0].fit << ", service "
+             << 100 * pop[0].service << "%" << endl;
+    }
+    evaluateAll(pop, sc);
+    sort(pop.begin(), pop.end(), [](const Plan &a, const Plan &b) { return a.fit < b.fit; });
+    report(pop[0], nscen);
+}
+
+/**************************************************************************/
+/*  Island k of nisl: evolve pop on the calling thread. After every       */
+/*  MIGRATE generations the MIGRANTS best plans go to island k+1 and the  */
+/*  plans that arrived from island k-1 replace the worst ones; a full     */
+/*  queue drops the migrants, an empty one is not waited for.             */
+/**************************************************************************/
+void island(int k, int nisl, vector<Plan> &pop, int ngens, const ScenSet &sc, vector<XBRing<Plan> > &ring) {
+    int g, i, worst;
+    Plan in;
+    mt19937 rng(1 + k);
+
+    initPopulation(pop, (int) pop.size(), rng);
+    for (g = 0; g < ngens; g++) {
+        for (i = 0; i < (int) pop.size(); i++) evaluate(pop[i], sc);
+        if (nisl > 1 && g % MIGRATE == MIGRATE - 1) {
+            sort(pop.begin(), pop.end(), [](const Plan &a, const Plan &b) { return a.fit < b.fit; });
+            for (i = 0; i < MIGRANTS && i < (int) pop.size(); i++)
+                xbRingPush(&ring[(k + 1) % nisl], pop[i]);
+            for (worst = (int) pop.size() - 1; worst >= ELITE && xbRingPop(&ring[k], &in); worst--)
+                pop[worst] = in;                /* Already evaluated on sc */
+        }
+        evolve(pop, rng);
+    }
+    for (i = 0; i < (int) pop.size(); i++) evaluate(pop[i], sc);
+    sort(pop.begin(), pop.end(), [](const Plan &a, const Plan &b) { return a.fit < b.fit; });
+}
+
+/**************************************************************************/
+/*  nisl islands of islpop plans on nisl threads; returns the best plan.  */
+/*  With nm the islands are pinned to its nodes in blocks and allocate    */
+/*  their populations there; with local they read a copy of the           */
+/*  scenarios made on their node instead of sc.                           */
+/**************************************************************************/
+Plan simIslands(int nisl, int islpop, int ngens, const ScenSet &sc, const XBNuma *nm, int local) {
+    int k, best = 0;
+    vector<vector<Plan> > pop(nisl);
+    vector<XBRing<Plan> > ring(nisl);
+    vector<ScenSet> rep;
+
+    for (k = 0; k < nisl; k++) xbRingInit(&ring[k], 2 * MIGRANTS);
+    if (nm != NULL && local) {
+        rep.resize(xbNumaNodes(nm));
+        xbNumaReplicate(nm, [&](int n) { rep[n] = sc; });
+    }
+    xbParallelChunks(nisl, 1, nisl, [&](int lo, int hi, int c) {
+        int node = 0;
+        cpu_set_t saved;
+
+        if (nm != NULL) {
+            node = xbNumaNodeOf(nm, c, nisl);
+            xbNumaPin(nm, node, &saved);
+        }
+        pop[c].resize(islpop);
+        island(c, nisl, pop[c], ngens, rep.empty() ? sc : rep[node], ring);
+        if (nm != NULL) xbNumaRestore(&saved);
+    });
+    for (k = 1; k < nisl; k++)
+        if (pop[k][0].fit < pop[best][0].fit) best = k;
+    return pop[best][0];
+}
+
+void simOptIslands(int nisl, int popsize, int ngens, int nscen) {
+    double t0 = clsClock();
+    ScenSet sc;
+    Plan best;
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);
+    best = simIslands(nisl, max(ELITE + 1, popsize / nisl), ngens, sc, PIN ? &NUMA : NULL, PIN);
+    clsRecord(&stats, "islands", clsClock() - t0, nisl);
+    cout << nisl << " islands: best " << best.fit << ", service " << 100 * best.service << "%" << endl;
+    report(best, nscen);
+}
+
+/**************************************************************************/
+/*  Weak scaling: n islands of popsize plans each on n threads; beyond    */
+/*  the cores the islands share them, so no efficiency is given           */
+/**************************************************************************/
+void scaling(int popsize, int ngens, int nscen) {
+    int n;
+    double t0, sec, sec1 = 0;
+    ScenSet sc;
+    Plan best;
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);
+    cout << "Cores: " << xbNumThreads() << endl;
+    for (n = 1; n <= MAXISLANDS; n *= 2) {
+        t0 = clsClock();
+        best = simIslands(n, popsize, ngens, sc, PIN ? &NUMA : NULL, PIN);
+        sec = clsClock() - t0;
+        if (n == 1) sec1 = sec;
+        cout << "  " << n << " islands: " << sec << " sec, ";
+        if (n <= xbNumThreads())
+            cout << "efficiency " << 100 * sec1 / sec << "%";
+        else
+            cout << "oversubscribed";
+        cout << ", best " << best.fit << endl;
+    }
+}
+
+/**************************************************************************/
+/*  Throughput per socket configuration: one island of popsize plans per  */
+/*  core of the first m nodes                                             */
+/**************************************************************************/
+void numaBench(int popsize, int ngens, int nscen) {
+    int m, k, mode, ncores;
+    double t0, sec;
+    ScenSet sc;
+    XBNuma sub;
+    const char *name[3] = {"unpinned", "pinned, shared scenarios", "pinned, local scenarios"};
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);   /* First touched on this node */
+    cout << xbNumaNodes(&NUMA) << " nodes:";
+    for (k = 0; k < xbNumaNodes(&NUMA); k++) cout << " " << NUMA.cpus[k].size();
+    cout << " cores" << endl;
+    for (m = 1; m <= xbNumaNodes(&NUMA); m++) {
+        sub.cpus.assign(NUMA.cpus.begin(), NUMA.cpus.begin() + m);
+        for (ncores = 0, k = 0; k < m; k++) ncores += (int) sub.cpus[k].size();
+        for (mode = (m == xbNumaNodes(&NUMA) ? 0 : 1); mode < 3; mode++) {
+            t0 = clsClock();
+            simIslands(ncores, popsize, ngens, sc, mode > 0 ? &sub : NULL, mode == 2);
+            sec = clsClock() - t0;
+            cout << "  " << m << " nodes, " << ncores << " islands, " << name[mode] << ": "
+                 << (double) ncores * popsize * (ngens + 1) * nscen / sec / 1e6 << " M evaluations/sec ("
+                 << sec << " sec)" << endl;
+        }
+    }
+}
+
+/**************************************************************************/
+/*  Structure-of-arrays evaluator against the per-scenario scalar loop    */
+/**************************************************************************/
+void bench(int nscen) {
+    int k;
+    double t0, tsoa, tscal, sumsoa = 0, sumscal = 0;
+    ScenSet sc;
+    vector<double> demsm;
+    vector<vector<double> > prod(BENCHPLANS, vector<double>(T));
+    vector<Plan> pop;
+    mt19937 rng(1);
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);
+    scenTranspose(&sc, demsm);
+    initPopulation(pop, BENCHPLANS, rng);
+    for (k = 0; k < BENCHPLANS; k++)
+        planProd(pop[k], &prod[k][0]);
+
+    t0 = clsClock();
+    for (k = 0; k < BENCHPLANS; k++)
+        sumscal += scenEvaluateScalar(&sc, &demsm[0], &prod[k][0], HOLDC, SHORTC, NULL).mean;
+    tscal = clsClock() - t0;
+    t0 = clsClock();
+    for (k = 0; k < BENCHPLANS; k++)
+        sumsoa += scenEvaluate(&sc, &prod[k][0], HOLDC, SHORTC, NULL).mean;
+    tsoa = clsClock() - t0;
+
+    cout << BENCHPLANS << " plans x " << nscen << " scenarios x " << T << " periods" << endl;
+    cout << "   scalar: " << tscal << " sec, SoA: " << tsoa << " sec, speedup " << tscal / tsoa << endl;
+    cout << "   difference of the results: " << fabs(sumsoa - sumscal) / max(1.0, fabs(sumscal)) << endl;
+}
+
+/*  Event rate of the line simulation on one thread */
+void desBench(int nscen) {
+    double t0, sec;
+    ScenSet sc;
+    vector<double> prod(T), real;
+    vector<Plan> pop;
+    mt19937 rng(1);
+
+    scenGenerate(&sc, T, nscen, &MEAN[0], CV, 1);
+    initPopulation(pop, 1, rng);
+    planProd(pop[0], &prod[0]);
+    DESEVENTS = 0;
+    t0 = clsClock();
+    simulate(pop[0], &prod[0], sc, real);
+    sec = clsClock() - t0;
+    cout << nscen << " simulations, " << DESEVENTS.load() << " events in " << sec << " sec: "
+         << DESEVENTS.load() / sec / 1e6 << " million events per sec" << endl;
+    cout << "   Wagner-Whitin plan: " << scenEvaluate(&sc, &prod[0], HOLDC, SHORTC, NULL).mean
+         << " planned, " << scenEvaluateReal(&sc, &real[0], HOLDC, SHORTC, NULL).mean << " simulated" << endl;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, popsize = 64, ngens = 50, nscen = 4096, dobench = 0, nisl = 0;
+    double avg;
+
+    SHORTC = -1;
+    clsGenerate(&DT, 1, 52, 0.8, 1);
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-gen") && i + 4 < argc) {
+            clsGenerate(&DT, atoi(argv[i + 1]), atoi(argv[i + 2]), atof(argv[i + 3]), atoi(argv[i + 4]));
+            i += 4;
+        } else if (!strcmp(argv[i], "-item") && i + 1 < argc)
+            ITEM = atoi(argv[++i]) - 1;
+        else if (!strcmp(argv[i], "-scen") && i + 1 < argc)
+            nscen = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-cv") && i + 1 < argc)
+            CV = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-shortc") && i + 1 < argc)
+            SHORTC = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-pop") && i + 1 < argc)
+            popsize = max(ELITE + 1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-gens") && i + 1 < argc)
+            ngens = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+            NTHREADS = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-gamma") && i + 1 < argc)
+            GAMMA = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-des"))
+            USEDES = 1;
+        else if (!strcmp(argv[i], "-islands") && i + 1 < argc)
+            nisl = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-bench"))
+            dobench = 1;
+        else if (!strcmp(argv[i], "-desbench"))
+            dobench = 2;
+        else if (!strcmp(argv[i], "-scaling"))
+            dobench = 3;
+        else if (!strcmp(argv[i], "-numabench"))
+            dobench = 4;
+        else if (!strcmp(argv[i], "-numa"))
+            PIN = 1;
+        else if (!clsRead(&DT, argv[i]))
+            return 1;
+    }
+    if (ITEM < 0 || ITEM >= DT.N) ITEM = 0;
+    xbNumaInit(&NUMA);
+    T = DT.T;
+    MEAN.assign(DT.dem.begin() + ITEM * T, DT.dem.begin() + (ITEM + 1) * T);
+    SETUPC = DT.setupc[ITEM];
+    HOLDC = DT.holdc[ITEM];
+    if (SHORTC < 0) SHORTC = 10 * HOLDC;   /* Default backlog cost */
+
+    for (avg = 0, i = 0; i < T; i++) avg += MEAN[i] / T;
+    LINE.ptime = DT.ptime[ITEM];
+    LINE.plen = max(1.0, LINE.ptime * avg / LINEUTIL);
+    LINE.stime = DT.stime[ITEM];
+    LINE.mtbf = 2 * LINE.plen;
+    LINE.mttr = 0.1 * LINE.plen;
+
+    if (dobench == 1)
+        bench(nscen);
+    else if (dobench == 2)
+        desBench(nscen);
+    else if (dobench == 3)
+        scaling(popsize, ngens, nscen);
+    else if (dobench == 4)
+        numaBench(popsize, ngens, nscen);
+    else if (nisl > 0)
+        simOptIslands(nisl, popsize, ngens, nscen);
+    else
+        simOpt(popsize, ngens, nscen);
+    clsPrintStats(&stats);
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbsolved.cxx
+  `````````````````
+  Solve service for lot-sizing series and scenario sets,
+  with the shared-memory transport of xbshm.h:
+
+    xbsolved -serve         runs the service: it creates
+                            the shared-memory region and
+                            the control socket and serves
+                            every client on a thread
+    xbsolved -els T         sends an uncapacitated lot
+                            sizing instance of T periods,
+                            solved by the Wagner-Whitin
+                            DP (xbww.h)
+    xbsolved -scen T n      sends a plan and n demand
+                            scenarios of T periods to be
+                            evaluated (xbscen.h)
+
+  A client writes the instance into its slot in the
+  layout of the service (SolveHead followed by the data
+  as doubles) and the service reads and answers in
+  place: the demands of a large scenario set are written
+  once by the client and never copied. With -repeat n
+  the client sends the instance n times and reports the
+  requests per second; with -par n it does so from n
+  threads (n connections). -quit stops the service.
+
+  Usage: xbsolved -serve | -quit | -els T | -scen T n
+                  [-repeat n] [-par n] [-seed n]
+                  [-shm name] [-socket path]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cerrno>
+#include <vector>
+#include <thread>
+#include <random>
+#include <atomic>
+#include <sched.h>
+#include "xbcls.h"
+#include "xbshm.h"
+#include "xbww.h"
+#include "xbscen.h"
+
+using namespace std;
+
+#define OP_ELS 1               /* Lot sizing: dem, setupc, prodc, holdc -> prod, setup */
+#define OP_SCEN 2              /* Scenarios: prod, dem[t*S+s] -> cost per scenario */
+#define OP_QUIT 3
+
+#define ST_OK 0
+#define ST_BADOP -1
+#define ST_TOOBIG -2           /* Data does not fit in a slot */
+
+typedef struct {
+    int32_t T, nscen, S, pad;           /* Periods, scenarios (padded to S) */
+    double holdc, shortc;               /* Scenario costs */
+    double obj, service;                /* Answer: cost (ELS, mean for SCEN) */
+} SolveHead;
+
+/****DATA****/
+const char *SHMNAME = "/xbsolved";      /* Shared-memory region */
+const char *SOCKPATH = "/tmp/xbsolved.sock";    /* Control socket */
+int LISTENFD = -1;
+atomic<int> STOP(0);
+
+/***********************************************************************/
+
+static inline double *slotData(char *slot) {
+    return (double *) (slot + sizeof(SolveHead));
+}
+
+/*  Doubles of a request and its answer, in the slot after SolveHead */
+size_t requestLen(int op, const SolveHead *h) {
+    if (op == OP_ELS) return (size_t) 6 * h->T;
+    return (size_t) h->T + (size_t) h->T * h->S + h->S;
+}
+
+/*  Serve request op in slot k. Return value: status */
+int serveRequest(XBShm *m, int op, int k) {
+    int t, T;
+    double *d;
+    vector<int> setup;
+    SolveHead *h = (SolveHead *) xbShmSlot(m, k);
+
+    if ((op != OP_ELS && op != OP_SCEN) || h->T <= 0 || (op == OP_SCEN && (h->nscen <= 0 ||
+        h->S < h->nscen || h->S % SCENLANES != 0)))
+        return ST_BADOP;
+    if (sizeof(SolveHead) + requestLen(op, h) * sizeof(double) > XBSHMSLOTBYTES) return ST_TOOBIG;
+    T = h->T;
+    d = slotData((char *) h);
+    if (op == OP_ELS) {                 /* dem | setupc | prodc | holdc | prod | setup */
+        setup.resize(T);
+        h->obj = wwSolve(T, d, d + T, d + 2 * T, d + 3 * T, d + 4 * T, &setup[0]);
+        for (t = 0; t < T; t++) d[5 * T + t] = setup[t];
+    } else {                            /* prod | dem | cost */
+        ScenResult r = scenEvaluateData(T, h->nscen, h->S, d + T, d, h->holdc, h->shortc,
+                                        d + T + (size_t) T * h->S);
+        h->obj = r.mean;
+        h->service = r.service;
+    }
+    return ST_OK;
+}
+
+/*  One client connection: control messages until it closes; only the   */
+/*  slots of the client process are served                                */
+void serveClient(XBShm *m, int fd) {
+    XBShmMsg msg;
+    pid_t peer = xbShmPeer(fd);
+
+    while (xbShmRecv(fd, &msg)) {
+        if (msg.op == OP_QUIT) {
+            STOP = 1;
+            shutdown(LISTENFD, SHUT_RDWR);  /* Ends accept() */
+            msg.status = ST_OK;
+        } else if (msg.slot >= XBSHMSLOTS || peer <= 0 || !xbShmServe(m, msg.slot, peer))
+            msg.status = ST_BADOP;
+        else {
+            msg.status = serveRequest(m, msg.op, msg.slot);
+            xbShmServed(m, msg.slot, peer);
+        }
+        if (!xbShmSend(fd, &msg)) break;
+    }
+    close(fd);
+}
+
+int serve() {
+    int fd;
+    XBShm m;
+
+    if (!xbShmCreate(&m, SHMNAME)) {
+        cout << "Cannot create shared memory " << SHMNAME << endl;
+        return 1;
+    }
+    if ((LISTENFD = xbShmListen(SOCKPATH)) < 0) {
+        cout << "Cannot listen on " << SOCKPATH << endl;
+        xbShmDetach(&m);
+        shm_unlink(SHMNAME);
+        return 1;
+    }
+    cout << "Serving on " << SOCKPATH << ", " << XBSHMSLOTS << " slots of " << (XBSHMSLOTBYTES >> 20)
+         << " MB in " << SHMNAME << endl;
+    while (!STOP) {
+        if ((fd = accept(LISTENFD, NULL, NULL)) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        thread(serveClient, &m, fd).detach();
+    }
+    close(LISTENFD);
+    unlink(SOCKPATH);
+    shm_unlink(SHMNAME);                /* Mappings of running clients stay valid */
+    cout << "Stopped" << endl;
+    return 0;
+}
+
+/***********************************************************************/
+
+/*  Write the instance into slot k. Return value: 0 if it does not fit */
+int writeRequest(XBShm *m, int k, int op, int T, int nscen, unsigned seed) {
+    int s, t;
+    double *d;
+    SolveHead *h = (SolveHead *) xbShmSlot(m, k);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> U(0.0, 1.0);
+    normal_distribution<double> N01(0.0, 1.0);
+    vector<double> mean(T);
+
+    memset(h, 0, sizeof(SolveHead));
+    h->T = T;
+    h->nscen = nscen;
+    h->S = (nscen + SCENLANES - 1) / SCENLANES * SCENLANES;
+    if (sizeof(SolveHead) + requestLen(op, h) * sizeof(double) > XBSHMSLOTBYTES) return 0;
+    d = slotData((char *) h);
+    if (op == OP_ELS) {
+        for (t = 0; t < T; t++) {
+            d[t] = floor(20 + 80 * U(rng));         /* dem */
+            d[T + t] = floor(200 + 400 * U(rng));   /* setupc */
+            d[2 * T + t] = floor(1 + 4 * U(rng));   /* prodc */
+            d[3 * T + t] = 1;                       /* holdc */
+        }
+    } else {
+        h->holdc = 1;
+        h->shortc = 10;
+        for (t = 0; t < T; t++) {
+            mean[t] = floor(20 + 80 * U(rng));
+            d[t] = mean[t] * 1.1;                   /* prod: 10% above the mean */
+        }
+        for (t = 0; t < T; t++)                     /* dem, in place period-major */
+            for (s = 0; s < h->S; s++)
+                d[T + (size_t) t * h->S + s] = (s < nscen ? max(0.0, mean[t] * (1 + 0.3 * N01(rng))) : 0.0);
+    }
+    return 1;
+}
+
+/*  Send request op (slot -1: none) and wait for the answer. Return value: status */
+int request(int fd, int op, int k) {
+    XBShmMsg msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.op = op;
+    msg.slot = (k < 0 ? 0 : k);
+    if (!xbShmSend(fd, &msg) || !xbShmRecv(fd, &msg)) return ST_BADOP;
+    return msg.status;
+}
+
+/*  One client thread: nrep requests on its own connection */
+int runClient(XBShm *m, int op, int T, int nscen, int nrep, unsigned seed, int print) {
+    int fd, k, r, t, status = ST_OK, nsetup = 0;
+    SolveHead *h;
+    double *d;
+
+    if ((fd = xbShmConnect(SOCKPATH)) < 0) {
+        cout << "Cannot connect to " << SOCKPATH << endl;
+        return ST_BADOP;
+    }
+    for (r = 0; r < nrep && status == ST_OK; r++) {
+        while ((k = xbShmTake(m)) < 0) sched_yield();   /* All slots in flight */
+        h = (SolveHead *) xbShmSlot(m, k);
+        if (!writeRequest(m, k, op, T, nscen, seed + r))
+            status = ST_TOOBIG;
+        else
+            status = request(fd, op, k);
+        if (status == ST_OK && print && r == 0) {
+            d = slotData((char *) h);
+            if (op == OP_ELS) {
+                for (t = 0; t < T; t++) nsetup += (d[5 * T + t] > 0.5);
+                cout << "Lot sizing, " << T << " periods: cost " << h->obj << ", " << nsetup << " setups"
+                     << endl;
+            } else
+                cout << "Scenarios, " << T << " periods x " << nscen << ": mean cost " << h->obj
+                     << ", service level " << h->service << endl;
+        }
+        xbShmFree(m, k);
+    }
+    close(fd);
+    return status;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, k, op = 0, T = 0, nscen = 0, nrep = 1, npar = 1, status;
+    unsigned seed = 1;
+    double t0, sec;
+    vector<thread> th;
+    vector<int> st;
+    XBShm m;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-serve"))
+            op = -1;
+        else if (!strcmp(argv[i], "-quit"))
+            op = OP_QUIT;
+        else if (!strcmp(argv[i], "-els") && i + 1 < argc) {
+            op = OP_ELS;
+            T = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-scen") && i + 2 < argc) {
+            op = OP_SCEN;
+            T = atoi(argv[++i]);
+            nscen = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-repeat") && i + 1 < argc)
+            nrep = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-par") && i + 1 < argc)
+            npar = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+            seed = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-shm") && i + 1 < argc)
+            SHMNAME = argv[++i];
+        else if (!strcmp(argv[i], "-socket") && i + 1 < argc)
+            SOCKPATH = argv[++i];
+    }
+    if (op == 0 || (op != -1 && op != OP_QUIT && (T <= 0 || (op == OP_SCEN && nscen <= 0)))) {
+        cout << "Usage: xbsolved -serve | -quit | -els T | -scen T n [-repeat n] [-par n] [-seed n]"
+             << " [-shm name] [-socket path]" << endl;
+        return 1;
+    }
+    if (op == -1) return serve();
+    if (op == OP_QUIT) {
+        if ((k = xbShmConnect(SOCKPATH)) < 0) {
+            cout << "Cannot connect to " << SOCKPATH << endl;
+            return 1;
+        }
+        status = request(k, OP_QUIT, -1);
+        close(k);
+        return status != ST_OK;
+    }
+
+    if (!xbShmAttach(&m, SHMNAME)) {
+        cout << "Cannot attach shared memory " << SHMNAME << " (is the service running?)" << endl;
+        return 1;
+    }
+    st.assign(npar, ST_OK);
+    t0 = clsClock();
+    for (k = 0; k < npar; k++)
+        th.push_back(thread([&, k]() { st[k] = runClient(&m, op, T, nscen, nrep, seed, k == 0); }));
+    for (k = 0; k < npar; k++) th[k].join();
+    sec = clsClock() - t0;
+    xbShmDetach(&m);
+
+    for (status = ST_OK, k = 0; k < npar; k++)
+        if (st[k] != ST_OK) status = st[k];
+    if (status == ST_TOOBIG)
+        cout << "Instance does not fit in a slot of " << (XBSHMSLOTBYTES >> 20) << " MB" << endl;
+    else if (status != ST_OK)
+        cout << "Request failed (status " << status << ")" << endl;
+    else if (nrep * npar > 1)
+        cout << nrep * npar << " requests in " << sec << " sec, " << nrep * npar / max(sec, 1e-9)
+             << " requests/sec" << endl;
+    return status != ST_OK;
+}
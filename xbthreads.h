@@ -0,0 +1,313 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbthreads.h
+  ````````````````
+  Parallel loops for the examples (pricing, separation,
+  batch solves) and a lock-free queue between threads.
+
+  Work is split into chunks of 'grain' consecutive
+  indices that are handed out to the threads in any
+  order. Chunk boundaries only depend on the loop size
+  and the grain, never on the number of threads or on
+  timing, so a caller that collects results per chunk
+  and merges them in chunk order (ordered reduction)
+  gets identical results on every run.
+
+  All parallel work runs as tasks on one work-stealing
+  scheduler per program:
+
+    a pool of one worker thread per core but one; each
+    worker has a deque of tasks, spawns onto its own
+    deque and runs its newest task, an idle worker
+    steals the oldest task of another deque; threads
+    outside the pool (main, optimizer callbacks) spawn
+    onto a shared deque
+    tasks belong to a task group (XBTaskGroup); waiting
+    for a group runs queued tasks meanwhile, so tasks
+    may spawn and wait for nested groups without
+    blocking a thread; a cancelled group, or a group
+    inside one, skips its tasks that have not started
+    and running tasks can poll xbCancelled()
+    a core budget counts the free cores: a worker needs
+    a core to run tasks and gives it back when it runs
+    out of work; optimizer runs take their threads from
+    the same budget (xbAcquireCores), so the workers and
+    the optimizer's threads never exceed the cores
+********************************************************/
+
+#ifndef XBTHREADS_H
+#define XBTHREADS_H
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+/* Default number of threads: one per core */
+static inline int xbNumThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int) n : 1;
+}
+
+/* Task group: pending counts the spawned tasks that have not finished */
+struct XBTaskGroup {
+    std::atomic<int> pending;
+    std::atomic<bool> cancel;
+    XBTaskGroup *parent;                /* Enclosing group or NULL */
+};
+
+typedef struct {
+    std::function<void()> fn;
+    XBTaskGroup *group;
+} XBTask;
+
+typedef struct {
+    std::mutex lock;
+    std::deque<XBTask> tasks;           /* Owner: back, thieves: front */
+} XBDeque;
+
+struct XBPool {
+    std::vector<XBDeque> dq;            /* 0: shared, k: worker k */
+    std::vector<std::thread> workers;
+    std::atomic<int> cores;             /* Core budget: free cores */
+    std::atomic<int> queued;            /* Tasks in the deques */
+    std::atomic<int> sleeping;
+    std::atomic<bool> stop;
+    std::mutex lock;                    /* For the sleepers */
+    std::condition_variable wake;
+    std::once_flag started;
+
+    XBPool() : dq(xbNumThreads()), cores(xbNumThreads() - 1), queued(0), sleeping(0), stop(false) {}
+    ~XBPool() {
+        size_t k;
+
+        {
+            std::lock_guard<std::mutex> lk(lock);
+            stop = true;
+        }
+        wake.notify_all();
+        for (k = 0; k < workers.size(); k++) workers[k].join();
+    }
+};
+
+/* Index of the deque of the calling thread: 0 outside the pool */
+static inline int &xbWorkerId() {
+    static thread_local int id = 0;
+    return id;
+}
+
+static inline void xbWorker(XBPool *pool, int id);
+
+/* The scheduler of the program; workers start with the first task */
+static inline XBPool *xbPool() {
+    static XBPool pool;
+    return &pool;
+}
+
+static inline void xbPoolStart(XBPool *pool) {
+    std::call_once(pool->started, [pool]() {
+        size_t k;
+        for (k = 1; k < pool->dq.size(); k++)
+            pool->workers.push_back(std::thread(xbWorker, pool, (int) k));
+    });
+}
+
+static inline void xbWakeSleepers(XBPool *pool) {
+    if (pool->sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lk(pool->lock);
+        pool->wake.notify_all();
+    }
+}
+
+/**************************************************************************/
+/* Core budget. The calling thread owns its core; xbAcquireCores adds up  */
+/* to want-1 free cores for an optimizer run with as many threads.        */
+/* Return value: number of threads granted (at least 1)                   */
+/**************************************************************************/
+static inline int xbAcquireCores(int want) {
+    XBPool *pool = xbPool();
+    int c = pool->cores.load(), n;
+
+    do {
+        n = std::max(0, std::min(want - 1, c));
+    } while (n > 0 && !pool->cores.compare_exchange_weak(c, c - n));
+    return n + 1;
+}
+
+/* Return the cores of a run with 'threads' threads from xbAcquireCores */
+static inline void xbReleaseCores(int threads) {
+    XBPool *pool = xbPool();
+
+    if (threads > 1) {
+        pool->cores += threads - 1;
+        xbWakeSleepers(pool);
+    }
+}
+
+static inline void xbGroupInit(XBTaskGroup *g, XBTaskGroup *parent) {
+    g->pending = 0;
+    g->cancel = false;
+    g->parent = parent;
+}
+
+static inline void xbCancel(XBTaskGroup *g) {
+    g->cancel = true;
+}
+
+static inline bool xbCancelled(const XBTaskGroup *g) {
+    for (; g != NULL; g = g->parent)
+        if (g->cancel.load(std::memory_order_relaxed)) return true;
+    return false;
+}
+
+static inline void xbSpawn(XBTaskGroup *g, const std::function<void()> &fn) {
+    XBPool *pool = xbPool();
+    XBDeque *d = &pool->dq[xbWorkerId()];
+    XBTask t;
+
+    xbPoolStart(pool);
+    t.fn = fn;
+    t.group = g;
+    g->pending++;
+    {
+        std::lock_guard<std::mutex> lk(d->lock);
+        d->tasks.push_back(t);
+    }
+    pool->queued++;
+    xbWakeSleepers(pool);
+}
+
+/* Run one task: the newest of the own deque, else the oldest of another.
+   Return value: false if there was none */
+static inline bool xbRunOne(XBPool *pool, int id) {
+    int k, n = (int) pool->dq.size();
+    bool found = false;
+    XBTask t;
+
+    if (pool->queued.load() == 0) return false;
+    for (k = 0; k < n && !found; k++) {
+        XBDeque *d = &pool->dq[(id + k) % n];
+        std::lock_guard<std::mutex> lk(d->lock);
+        if (d->tasks.empty()) continue;
+        if (k == 0) {
+            t = d->tasks.back();
+            d->tasks.pop_back();
+        } else {
+            t = d->tasks.front();
+            d->tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found) return false;
+    pool->queued--;
+    if (!xbCancelled(t.group)) t.fn();
+    t.group->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+/* Wait for the tasks of g, running queued tasks meanwhile */
+static inline void xbWait(XBTaskGroup *g) {
+    XBPool *pool = xbPool();
+
+    while (g->pending.load(std::memory_order_acquire) > 0)
+        if (!xbRunOne(pool, xbWorkerId())) std::this_thread::yield();
+}
+
+/* Worker loop: hold a core while there is work, sleep without one */
+static inline void xbWorker(XBPool *pool, int id) {
+    int c;
+
+    xbWorkerId() = id;
+    while (!pool->stop.load()) {
+        c = pool->cores.load();
+        if (c > 0 && pool->queued.load() > 0 && pool->cores.compare_exchange_weak(c, c - 1)) {
+            while (xbRunOne(pool, id));
+            pool->cores++;
+            xbWakeSleepers(pool);
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(pool->lock);
+        pool->sleeping++;
+        pool->wake.wait(lk, [pool]() {
+            return pool->stop.load() || (pool->queued.load() > 0 && pool->cores.load() > 0);
+        });
+        pool->sleeping--;
+    }
+}
+
+/**************************************************************************/
+/* Call body(lo, hi, chunk) for the chunks [lo,hi) of [0,n) of size       */
+/* 'grain' on up to 'nthreads' threads (0: one per core). Chunk k covers  */
+/* [k*grain, min(n,(k+1)*grain)). The chunks are shared by nthreads-1     */
+/* tasks and the caller, so a body may run a nested parallel loop.        */
+/* Return value: number of chunks                                         */
+/**************************************************************************/
+static inline int xbParallelChunks(int n, int grain, int nthreads,
+                                   const std::function<void(int, int, int)> &body) {
+    int i, nchunks;
+    std::atomic<int> next(0);
+    XBTaskGroup g;
+
+    if (grain < 1) grain = 1;
+    nchunks = (n + grain - 1) / grain;
+    if (nthreads <= 0) nthreads = xbNumThreads();
+    if (nthreads > nchunks) nthreads = nchunks;
+
+    auto work = [&]() {
+        int k;
+        while ((k = next++) < nchunks)
+            body(k * grain, (k + 1) * grain < n ? (k + 1) * grain : n, k);
+    };
+    xbGroupInit(&g, NULL);
+    for (i = 1; i < nthreads; i++)          /* The caller is runner 0 */
+        xbSpawn(&g, work);
+    work();
+    xbWait(&g);
+
+    return nchunks;
+}
+
+/**************************************************************************/
+/* Bounded queue from one producer thread to one consumer thread without  */
+/* locks: only the producer writes tail and only the consumer writes      */
+/* head, the release/acquire pairs publish the slot contents.             */
+/**************************************************************************/
+template <class T> struct XBRing {
+    std::vector<T> buf;                 /* size+1 slots, one is kept free */
+    alignas(64) std::atomic<unsigned> head;   /* Next slot to read */
+    alignas(64) std::atomic<unsigned> tail;   /* Next slot to write */
+};
+
+template <class T> static inline void xbRingInit(XBRing<T> *r, int size) {
+    r->buf.resize(size + 1);
+    r->head = 0;
+    r->tail = 0;
+}
+
+/* Return value: false if the queue is full */
+template <class T> static inline bool xbRingPush(XBRing<T> *r, const T &x) {
+    unsigned t = r->tail.load(std::memory_order_relaxed), n = (t + 1) % r->buf.size();
+
+    if (n == r->head.load(std::memory_order_acquire)) return false;
+    r->buf[t] = x;
+    r->tail.store(n, std::memory_order_release);
+    return true;
+}
+
+/* Return value: false if the queue is empty */
+template <class T> static inline bool xbRingPop(XBRing<T> *r, T *x) {
+    unsigned h = r->head.load(std::memory_order_relaxed);
+
+    if (h == r->tail.load(std::memory_order_acquire)) return false;
+    *x = r->buf[h];
+    r->head.store((h + 1) % r->buf.size(), std::memory_order_release);
+    return true;
+}
+
+#endif
@@ -0,0 +1,303 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbtune.cxx
+  ```````````````
+  Tuning of the optimizer controls of a solver (model
+  family) over an instance corpus, by racing:
+
+    the search space is a list of controls with their
+    candidate values, the first value being the current
+    setting; configuration 0 takes the first values, the
+    others are drawn at random (all of them if the space
+    is small enough)
+    in round r all configurations still in the race
+    solve instance r of the corpus, in parallel; a run
+    writes the configuration to a parameter file (see
+    xbparams.h) and calls the solver with -params
+    after RACEMIN rounds a configuration is dropped when
+    its total time exceeds RACEFACTOR times the best
+    total plus RACESLACK sec per round; configuration 0
+    stays in the race as the reference
+    the fastest configuration over the whole corpus is
+    written to the parameter file of the family, which
+    the solver loads at startup
+
+  A corpus file has one instance per line: the arguments
+  of the solver for this instance. A run that fails or
+  exceeds the time limit (-runtime) counts PENALTY times
+  the time limit, as does a run answered from the
+  solver's solution cache (-cache in the corpus, see
+  xbcache.h), which measures no solve. Parallel runs share the cores, so -par
+  should not exceed the number of cores divided by the
+  optimizer threads per run.
+
+  The built-in search space is for the family 'cutstk'
+  (xbcutstk), whose instances are data files; -space
+  reads one from a file with lines 'NAME value1 value2
+  ...'. xbels has no instance input and is not tuned.
+
+  Usage: xbtune -family name -solver command -corpus file
+                [-space file] [-configs n] [-par n]
+                [-runtime sec] [-out file] [-seed n]
+
+  (c) 2008 Fair Isaac Corporation
+********************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <sys/wait.h>
+#include "xbcls.h"
+#include "xbcache.h"
+#include "xbparams.h"
+#include "xbthreads.h"
+
+using namespace std;
+
+#define RACEMIN 3              /* Rounds before the first elimination */
+#define RACEFACTOR 1.3         /* Drop above this factor of the best total */
+#define RACESLACK 0.05         /* ... plus this time per round (sec) */
+#define PENALTY 10             /* Factor on the time limit for failed runs */
+
+typedef struct {
+    string name;                        /* Control without XPRS_ */
+    vector<double> value;               /* Candidate values, first: current */
+} TuneControl;
+
+typedef struct {
+    vector<int> choice;                 /* Value index per control */
+    double total;                       /* Time over the rounds run */
+    int alive;
+} TuneConfig;
+
+/****DATA****/
+vector<TuneControl> SPACE;              /* Search space */
+vector<string> CORPUS;                  /* Solver arguments per instance */
+string SOLVER;                          /* Solver command */
+int RUNTIME = 0;                        /* Time limit per run (sec), 0: none */
+atomic<int> CACHEHITS(0);               /* Runs answered from the solver's cache */
+CLSStats stats;
+
+/***********************************************************************/
+
+void addControl(const char *name, const vector<double> &value) {
+    TuneControl c;
+
+    c.name = name;
+    c.value = value;
+    SPACE.push_back(c);
+}
+
+/*  Built-in search spaces; the first value is the current setting */
+int defaultSpace(const char *family) {
+    if (!strcmp(family, "cutstk")) {          /* Master problems of xbcutstk */
+        addControl("CUTSTRATEGY", {-1, 0, 1, 2, 3});
+        addControl("PRESOLVE", {1, 0});
+        addControl("PREPROBING", {-1, 0, 1, 3});
+        addControl("HEURSTRATEGY", {-1, 0, 2, 3});
+        addControl("DEFAULTALG", {1, 2, 3});
+    } else
+        return 0;
+    return 1;
+}
+
+int readSpace(const char *fname) {
+    double v;
+    string line, name;
+    vector<double> value;
+    ifstream in(fname);
+
+    while (getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        istringstream ls(line);
+        if (!(ls >> name)) continue;
+        value.clear();
+        while (ls >> v) value.push_back(v);
+        if (!value.empty()) addControl(name.c_str(), value);
+    }
+    return !SPACE.empty();
+}
+
+int readCorpus(const char *fname) {
+    string line;
+    ifstream in(fname);
+
+    while (getline(in, line))
+        if (line.find_first_not_of(" \t") != string::npos && line[0] != '#')
+            CORPUS.push_back(line);
+    return !CORPUS.empty();
+}
+
+/*  Configuration 0 and up to n-1 distinct random ones */
+void makeConfigs(vector<TuneConfig> &conf, int n, mt19937 &rng) {
+    int k, j, tries;
+    double size = 1;
+    TuneConfig c;
+
+    for (j = 0; j < (int) SPACE.size(); j++) size *= SPACE[j].value.size();
+    n = (int) min((double) n, size);
+    c.choice.assign(SPACE.size(), 0);
+    c.total = 0;
+    c.alive = 1;
+    conf.assign(1, c);
+    for (tries = 0; (int) conf.size() < n && tries < 100 * n; tries++) {
+        for (j = 0; j < (int) SPACE.size(); j++)
+            c.choice[j] = rng() % SPACE[j].value.size();
+        for (k = 0; k < (int) conf.size() && conf[k].choice != c.choice; k++);
+        if (k == (int) conf.size()) conf.push_back(c);
+    }
+}
+
+void configParams(const TuneConfig &c, XBParams *pr) {
+    int j;
+
+    pr->name.clear();
+    pr->value.clear();
+    for (j = 0; j < (int) SPACE.size(); j++)
+        xbSetParam(pr, SPACE[j].name, SPACE[j].value[c.choice[j]]);
+}
+
+/*  Solve instance i with configuration k; returns the (penalized) time */
+double runConfig(const TuneConfig &c, int k, int i) {
+    int status;
+    double t0, sec;
+    char fname[64];
+    string cmd;
+    XBParams pr;
+
+    sprintf(fname, "xbtune_%d.prm", k);
+    configParams(c, &pr);
+    xbWriteParams(fname, &pr, NULL);
+    if (RUNTIME > 0) cmd = "timeout " + to_string(RUNTIME) + " ";
+    cmd += SOLVER + " " + CORPUS[i] + " -params " + fname + " > /dev/null 2>&1";
+    t0 = clsClock();
+    status = system(cmd.c_str());
+    sec = clsClock() - t0;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == XBCACHEHIT)
+        CACHEHITS++;
+    if (status != 0)                    /* Failed, timed out or cache hit */
+        sec = PENALTY * (RUNTIME > 0 ? RUNTIME : sec);
+    return sec;
+}
+
+/**************************************************************************/
+/*  Race the configurations over the corpus.                              */
+/*  Return value: index of the winning configuration                      */
+/**************************************************************************/
+int race(vector<TuneConfig> &conf, int npar) {
+    int i, k, r, best, nalive = (int) conf.size();
+    double t0, bestt;
+    vector<int> alive;
+    vector<double> sec(conf.size());
+
+    for (r = 0; r < (int) CORPUS.size(); r++) {
+        t0 = clsClock();
+        alive.clear();
+        for (k = 0; k < (int) conf.size(); k++)
+            if (conf[k].alive) alive.push_back(k);
+        xbParallelChunks((int) alive.size(), 1, npar, [&](int lo, int hi, int c) {
+            sec[alive[c]] = runConfig(conf[alive[c]], alive[c], r);
+        });
+        for (i = 0; i < (int) alive.size(); i++) conf[alive[i]].total += sec[alive[i]];
+        clsRecord(&stats, "solver runs", clsClock() - t0, (long) alive.size());
+
+        for (bestt = 1e300, i = 0; i < (int) alive.size(); i++) bestt = min(bestt, conf[alive[i]].total);
+        if (r + 1 >= RACEMIN)                     /* Eliminate */
+            for (i = 0; i < (int) alive.size(); i++) {
+                k = alive[i];
+                if (k > 0 && conf[k].total > RACEFACTOR * bestt + RACESLACK * (r + 1)) {
+                    conf[k].alive = 0;
+                    nalive--;
+                }
+            }
+        cout << "Round " << r + 1 << " (" << CORPUS[r] << "): " << alive.size() << " configurations, best "
+             << bestt << " sec, " << nalive << " left" << endl;
+    }
+
+    for (best = 0, k = 1; k < (int) conf.size(); k++)
+        if (conf[k].alive && conf[k].total < conf[best].total) best = k;
+    return best;
+}
+
+/***********************************************************************/
+
+int main(int argc, char **argv) {
+    int i, j, k, best, nconf = 20, npar = 0;
+    unsigned seed = 1;
+    const char *family = NULL, *corpus = NULL, *space = NULL;
+    string out;
+    char header[256];
+    vector<TuneConfig> conf;
+    XBParams pr;
+    mt19937 rng;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-family") && i + 1 < argc)
+            family = argv[++i];
+        else if (!strcmp(argv[i], "-solver") && i + 1 < argc)
+            SOLVER = argv[++i];
+        else if (!strcmp(argv[i], "-corpus") && i + 1 < argc)
+            corpus = argv[++i];
+        else if (!strcmp(argv[i], "-space") && i + 1 < argc)
+            space = argv[++i];
+        else if (!strcmp(argv[i], "-configs") && i + 1 < argc)
+            nconf = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-par") && i + 1 < argc)
+            npar = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-runtime") && i + 1 < argc)
+            RUNTIME = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-out") && i + 1 < argc)
+            out = argv[++i];
+        else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+            seed = atoi(argv[++i]);
+    }
+    if (family == NULL || SOLVER.empty() || corpus == NULL) {
+        cout << "Usage: xbtune -family name -solver command -corpus file [-space file] [-configs n]"
+             << " [-par n] [-runtime sec] [-out file] [-seed n]" << endl;
+        return 1;
+    }
+    if (space != NULL ? !readSpace(space) : !defaultSpace(family)) {
+        cout << "No search space for family " << family << endl;
+        return 1;
+    }
+    if (!readCorpus(corpus)) {
+        cout << "Empty corpus " << corpus << endl;
+        return 1;
+    }
+    if (out.empty()) out = string("xb") + family + ".prm";
+
+    rng.seed(seed);
+    shuffle(CORPUS.begin(), CORPUS.end(), rng);
+    makeConfigs(conf, nconf, rng);
+    cout << conf.size() << " configurations, " << CORPUS.size() << " instances" << endl;
+    best = race(conf, npar);
+
+    cout << "Best configuration: " << conf[best].total << " sec, current settings " << conf[0].total
+         << " sec" << endl;
+    for (j = 0; j < (int) SPACE.size(); j++)
+        cout << "   " << SPACE[j].name << " " << SPACE[j].value[conf[best].choice[j]] << endl;
+    configParams(conf[best], &pr);
+    snprintf(header, sizeof(header), "xbtune: family %s, %d instances, %g sec against %g sec", family,
+             (int) CORPUS.size(), conf[best].total, conf[0].total);
+    if (!xbWriteParams(out.c_str(), &pr, header)) {
+        cout << "Cannot write " << out << endl;
+        return 1;
+    }
+    cout << "Written to " << out << endl;
+    if (CACHEHITS > 0)
+        cout << CACHEHITS << " runs were answered from the solver's cache and counted as failed" << endl;
+    for (k = 0; k < (int) conf.size(); k++)
+        remove(("xbtune_" + to_string(k) + ".prm").c_str());
+    clsPrintStats(&stats);
+
+    return 0;
+}
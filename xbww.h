@@ -0,0 +1,246 @@
+/********************************************************
+  Xpress-BCL C++ Example Problems
+  ===============================
+
+  file xbww.h
+  ```````````
+  Wagner-Whitin dynamic program for the uncapacitated
+  single-item lot sizing problem: production in period
+  s covers the demand of periods s..e, at a setup cost,
+  a unit production cost and unit holding costs for
+  every period the stock is carried.
+
+  F[e+1] = min{ F[s] + cost(s,e) : s <= e }
+
+  Used as heuristic/exact solver for ELS and as pricing
+  routine for the lot sizing decompositions.
+
+  WWDyn keeps the optimal plan under a sequence of
+  single-period changes of demand or costs. With
+  Dc[t] the demand of periods 0..t-1 the recursion is
+  a lower envelope of lines in Dc[e+1]:
+    F[e+1] = min{ A[s] + (prodc[s]-H[s])*Dc[e+1] } + DH[e+1]
+  which a Li Chao tree over the query points evaluates
+  in O(log T). A change in period k leaves F[0..k]
+  unchanged; the update re-inserts the lines 0..k and
+  recomputes F[k+1..T], in O(T log T) overall.
+********************************************************/
+
+#ifndef XBWW_H
+#define XBWW_H
+
+#include <vector>
+#include <algorithm>
+
+/**************************************************************************/
+/* Input data:                                                            */
+/*   T:          Number of periods                                        */
+/*   dem[t]:     Demand in period t                                       */
+/*   setupc[t]:  Setup cost in period t                                   */
+/*   prodc[t]:   Unit production cost in period t                         */
+/*   holdc[t]:   Unit holding cost from t to t+1 (NULL for none)          */
+/* Return values:                                                         */
+/*   prod[t]:    Production in period t of an optimal plan (may be NULL)  */
+/*   setup[t]:   1 if there is a setup in period t (may be NULL)          */
+/*   F:          Cost of the optimal plan                                 */
+/**************************************************************************/
+static inline double wwSolve(int T, const double *dem, const double *setupc, const double *prodc,
+                             const double *holdc, double *prod, int *setup) {
+    int s, e, t;
+    double c, h;
+    std::vector<double> F(T + 1), H(T + 1);
+    std::vector<int> pred(T + 1);
+
+    H[0] = 0;                                 /* H[t]: holding cost 0..t-1 */
+    for (t = 0; t < T; t++)
+        H[t + 1] = H[t] + (holdc != NULL ? holdc[t] : 0);
+
+    F[0] = 0;
+    for (e = 0; e < T; e++) {
+        F[e + 1] = 1e300;
+        pred[e + 1] = -1;
+    }
+    for (s = 0; s < T; s++) {
+        if (dem[s] == 0 && F[s] < F[s + 1]) { /* Nothing to produce for s */
+            F[s + 1] = F[s];
+            pred[s + 1] = -1;
+        }
+        c = setupc[s];
+        for (e = s; e < T; e++) {             /* Cost of producing s..e in s */
+            h = H[e] - H[s];
+            c += dem[e] * (prodc[s] + h);
+            if (F[s] + c < F[e + 1]) {
+                F[e + 1] = F[s] + c;
+                pred[e + 1] = s;
+            }
+        }
+    }
+
+    for (t = 0; t < T; t++) {
+        if (prod != NULL) prod[t] = 0;
+        if (setup != NULL) setup[t] = 0;
+    }
+    for (e = T; e > 0; e = (pred[e] >= 0 ? pred[e] : e - 1))   /* Recover the plan */
+        if (pred[e] >= 0) {
+            if (setup != NULL) setup[pred[e]] = 1;
+            if (prod != NULL)
+                for (t = pred[e]; t < e; t++) prod[pred[e]] += dem[t];
+        }
+
+    return F[T];
+}
+
+/**************************************************************************/
+/* Dynamic Wagner-Whitin                                                  */
+/**************************************************************************/
+typedef struct {
+    int T;
+    std::vector<double> dem, setupc, prodc, holdc;
+    std::vector<double> Dc;       /* Dc[t]: demand of periods 0..t-1 */
+    std::vector<double> H;        /* H[t]: holding cost of periods 0..t-1 */
+    std::vector<double> DH;       /* DH[t]: sum of dem[j]*H[j], j < t */
+    std::vector<double> F;        /* F[t]: optimal cost of periods 0..t-1 */
+    std::vector<int> pred;        /* Production period covering t-1, -1 none */
+    std::vector<double> slope, icpt;  /* Line s of the envelope */
+    std::vector<int> node;        /* Li Chao tree: line per node, -1 for none */
+    int lo;                       /* First period queried in the tree */
+} WWDyn;
+
+static inline double wwLine(const WWDyn *w, int s, int e) {
+    return w->icpt[s] + w->slope[s] * w->Dc[e + 1];
+}
+
+/* Insert line s into the tree over the periods lo..T-1 */
+static inline void wwInsert(WWDyn *w, int s) {
+    int nd = 1, lo = w->lo, hi = w->T - 1, mid, cur, left;
+
+    for (;;) {
+        cur = w->node[nd];
+        if (cur < 0) {
+            w->node[nd] = s;
+            return;
+        }
+        mid = (lo + hi) / 2;
+        left = wwLine(w, s, lo) < wwLine(w, cur, lo);
+        if (wwLine(w, s, mid) < wwLine(w, cur, mid)) {
+            w->node[nd] = s;              /* Keep the better line at mid */
+            s = cur;
+            left = !left;
+        }
+        if (lo == hi) return;
+        if (left) {                       /* The other line wins on one side */
+            nd = 2 * nd;
+            hi = mid;
+        } else {
+            nd = 2 * nd + 1;
+            lo = mid + 1;
+        }
+    }
+}
+
+/* Lowest line at period e; returns its value, line in 'arg' */
+static inline double wwQuery(const WWDyn *w, int e, int *arg) {
+    int nd = 1, lo = w->lo, hi = w->T - 1, mid;
+    double v, best = 1e300;
+
+    *arg = -1;
+    while (nd < (int) w->node.size() && w->node[nd] >= 0) {
+        v = wwLine(w, w->node[nd], e);
+        if (v < best) {
+            best = v;
+            *arg = w->node[nd];
+        }
+        if (lo == hi) break;
+        mid = (lo + hi) / 2;
+        if (e <= mid) {
+            nd = 2 * nd;
+            hi = mid;
+        } else {
+            nd = 2 * nd + 1;
+            lo = mid + 1;
+        }
+    }
+    return best;
+}
+
+static inline void wwLineOf(WWDyn *w, int s) {
+    w->slope[s] = w->prodc[s] - w->H[s];
+    w->icpt[s] = w->F[s] + w->setupc[s] - w->slope[s] * w->Dc[s] - w->DH[s];
+}
+
+/* Recompute F[k+1..T], given that F[0..k] are still valid */
+static inline double wwDynSolve(WWDyn *w, int k) {
+    int s, e, t, arg;
+    double v;
+
+    for (t = k; t < w->T; t++) {          /* Cumulative data from k on */
+        w->Dc[t + 1] = w->Dc[t] + w->dem[t];
+        w->H[t + 1] = w->H[t] + w->holdc[t];
+        w->DH[t + 1] = w->DH[t] + w->dem[t] * w->H[t];
+    }
+
+    w->lo = k;
+    w->node.assign(4 * (w->T - k) + 4, -1);
+    for (s = 0; s <= k; s++) {            /* Lines with unchanged F[s] */
+        wwLineOf(w, s);
+        wwInsert(w, s);
+    }
+    for (e = k; e < w->T; e++) {
+        v = wwQuery(w, e, &arg) + w->DH[e + 1];
+        w->F[e + 1] = v;
+        w->pred[e + 1] = arg;
+        if (w->dem[e] == 0 && w->F[e] < v) {  /* Nothing to produce for e */
+            w->F[e + 1] = w->F[e];
+            w->pred[e + 1] = -1;
+        }
+        if (e + 1 < w->T) {
+            wwLineOf(w, e + 1);
+            wwInsert(w, e + 1);
+        }
+    }
+    return w->F[w->T];
+}
+
+static inline double wwDynInit(WWDyn *w, int T, const double *dem, const double *setupc,
+                               const double *prodc, const double *holdc) {
+    w->T = T;
+    w->dem.assign(dem, dem + T);
+    w->setupc.assign(setupc, setupc + T);
+    w->prodc.assign(prodc, prodc + T);
+    w->holdc.assign(T, 0);
+    if (holdc != NULL) w->holdc.assign(holdc, holdc + T);
+    w->Dc.assign(T + 1, 0);
+    w->H.assign(T + 1, 0);
+    w->DH.assign(T + 1, 0);
+    w->F.assign(T + 1, 0);
+    w->pred.assign(T + 1, -1);
+    w->slope.assign(T, 0);
+    w->icpt.assign(T, 0);
+    return wwDynSolve(w, 0);
+}
+
+/* Change demand and costs of period k; returns the new optimal cost */
+static inline double wwDynUpdate(WWDyn *w, int k, double dem, double setupc, double prodc, double holdc) {
+    w->dem[k] = dem;
+    w->setupc[k] = setupc;
+    w->prodc[k] = prodc;
+    w->holdc[k] = holdc;
+    return wwDynSolve(w, k);
+}
+
+/* Current optimal plan */
+static inline void wwDynPlan(const WWDyn *w, double *prod, int *setup) {
+    int e, t;
+
+    for (t = 0; t < w->T; t++) {
+        if (prod != NULL) prod[t] = 0;
+        if (setup != NULL) setup[t] = 0;
+    }
+    for (e = w->T; e > 0; e = (w->pred[e] >= 0 ? w->pred[e] : e - 1))
+        if (w->pred[e] >= 0) {
+            if (setup != NULL) setup[w->pred[e]] = 1;
+            if (prod != NULL) prod[w->pred[e]] = w->Dc[e] - w->Dc[w->pred[e]];
+        }
+}
+
+#endif